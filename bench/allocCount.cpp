@@ -0,0 +1,72 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "allocCount.h"
+
+// relaxed atomics since the parallel scanner allocates from several threads
+static std::atomic<std::size_t> sCount {0};
+static std::atomic<std::size_t> sBytes {0};
+
+std::size_t AllocCount::count() noexcept {
+    return sCount.load(std::memory_order_relaxed);
+}
+
+std::size_t AllocCount::bytes() noexcept {
+    return sBytes.load(std::memory_order_relaxed);
+}
+
+void AllocCount::reset() noexcept {
+    sCount.store(0, std::memory_order_relaxed);
+    sBytes.store(0, std::memory_order_relaxed);
+}
+
+static void * allocate(std::size_t size) noexcept {
+    sCount.fetch_add(1, std::memory_order_relaxed);
+    sBytes.fetch_add(size, std::memory_order_relaxed);
+
+    return std::malloc(size ? size : 1);
+}
+
+void * operator new(std::size_t size) {
+    void * ptr = allocate(size);
+
+    if (!ptr) throw std::bad_alloc();
+
+    return ptr;
+}
+
+void * operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,21 @@
+/*
+defines AllocCount which counts the heap allocations made by the benchmarked code
+
+linking allocCount.cpp into a benchmark replaces the global operator new/delete w counting versions
+*/
+
+#ifndef ALLOC_COUNT_H
+#define ALLOC_COUNT_H
+
+#include <cstddef>
+
+class AllocCount {
+public:
+    // calls to operator new (all forms) and bytes requested since the last reset
+    static std::size_t count() noexcept;
+    static std::size_t bytes() noexcept;
+
+    static void reset() noexcept;
+};
+
+#endif
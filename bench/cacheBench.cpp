@@ -0,0 +1,204 @@
+/*
+benchmark for the binary AST cache (see ../parse/astCache.h)
+
+usage: cacheBench [--reps=N] [--threads=N] [corpus options] [file.crisp]
+
+times the front end of a compile w/o the cache (scan + parse, streamed the way crisp runs it or w the bodies on N
+threads) against one that hits it:
+    key:   hash of the source the cache file is looked up by
+    open:  map the file, checksum it and check its records
+    load:  rebuild the arena AST for codegen
+the hit is the sum of the three. printing the AST from the parse (ASTProg::printNode) is also timed against printing
+it straight from the mapped file (ASTCache::print), the two have to print the same tree and load() has to give back
+a tree that prints the same too
+
+reports the best of reps runs of each along w the size of the cache file and of the AST arena it replaces
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../scan/scan.h"
+#include "../parse/astCache.h"
+#include "../parse/astNodes.h"
+#include "../parse/parse.h"
+#include "../parse/symbols.h"
+#include "corpus.h"
+
+// streambuf that throws away the output
+class Discard : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+};
+
+// best time of reps runs of f
+template <typename F>
+static double best(int reps, F f) {
+    double result = 1e30;
+
+    for (int i = 0; i < reps; ++i) {
+        auto start = std::chrono::steady_clock::now();
+
+        f();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result = std::min(result, elapsed.count());
+    }
+
+    return result;
+}
+
+static int usage() {
+    std::fprintf(stderr, "usage: cacheBench [--reps=N] [--threads=N] [options] [file.crisp]\n%s", Corpus::usage());
+    return 1;
+}
+
+int main(int argc, char * argv[]) {
+    Corpus::Options options;
+    options.mBytes = 8 << 20;
+
+    int reps = 5;
+    unsigned threads = 1;
+    std::string path;
+
+    for (int i = 1; i < argc; ++i) {
+        const char * arg = argv[i];
+
+        if (std::strncmp(arg, "--reps=", 7) == 0) reps = std::max(1, std::atoi(arg + 7));
+        else if (std::strncmp(arg, "--threads=", 10) == 0) threads = std::max(0, std::atoi(arg + 10));
+        else if (Corpus::parseArg(options, arg));
+        else if (arg[0] != '-' && path.empty()) path = arg;
+        else return usage();
+    }
+
+    bool generated = path.empty();
+
+    if (generated) path = Corpus::writeTemp(Corpus(options).generate());
+
+    char dir[] = "/tmp/crispCacheXXXXXX";
+
+    if (!mkdtemp(dir)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+
+    std::ostream discard {nullptr};
+    Discard sink;
+    std::ostream out {&sink};
+
+    // the parse every cold run does, kept from the last one to write the cache and print from
+    std::unique_ptr<Scanner> scanner;
+    std::unique_ptr<SymbolTable> symTable;
+    std::unique_ptr<StringTable> strTable;
+    std::unique_ptr<Parser> parser;
+
+    Parser::Options parserOptions;
+    parserOptions.mThreads = threads;
+
+    double parse = best(reps, [&]() {
+        parser.reset();
+
+        scanner = std::make_unique<Scanner>(path.c_str());
+        symTable = std::make_unique<SymbolTable>();
+        strTable = std::make_unique<StringTable>();
+
+        if (threads == 1) scanner->streamTokens();
+        else scanner->scanTokensParallel(threads);
+
+        parser = std::make_unique<Parser>(*scanner, *symTable, *strTable, path.c_str(), &discard, &discard, parserOptions);
+    });
+
+    if (!parser->isValid()) {
+        std::fprintf(stderr, "%s: %d errors, only a source that parses cleanly is cached\n", path.c_str(), parser->getNumErrors());
+        return 1;
+    }
+
+    const SourceBuffer& source = scanner->source();
+    std::uint64_t key = 0;
+
+    double hash = best(reps, [&]() {
+        key = ASTCache::key(source, Parser::DefaultMaxDepth, {});
+    });
+
+    std::string file = ASTCache::path(dir, key);
+
+    double write = best(reps, [&]() {
+        if (!ASTCache::write(file, key, *parser)) {
+            std::fprintf(stderr, "could not write %s\n", file.c_str());
+            std::exit(1);
+        }
+    });
+
+    double open = best(reps, [&]() {
+        ASTCache cache {file.c_str(), key};
+
+        if (!cache.isValid()) {
+            std::fprintf(stderr, "%s does not check out\n", file.c_str());
+            std::exit(1);
+        }
+    });
+
+    double load = best(reps, [&]() {
+        ASTCache cache {file.c_str(), key};
+        StringTable strings {};
+
+        cache.load(strings);
+    });
+
+    ASTCache cache {file.c_str(), key};
+
+    double printParsed = best(reps, [&]() {
+        parser->getRoot()->printNode(out);
+    });
+
+    double printCached = best(reps, [&]() {
+        cache.print(out);
+    });
+
+    // both printers and the loaded tree have to agree w the parse
+    std::ostringstream parsedTree, cachedTree, loadedTree;
+    StringTable strings {};
+
+    parser->getRoot()->printNode(parsedTree);
+    cache.print(cachedTree);
+    cache.load(strings)->printNode(loadedTree);
+
+    std::string tree = parsedTree.str();
+    const char * same = tree == cachedTree.str() && tree == loadedTree.str() ? "yes" : "NO";
+
+    std::size_t bytes = source.length();
+    std::size_t cacheBytes = SourceBuffer(file.c_str()).length();
+    std::size_t nodes = std::count(tree.begin(), tree.end(), '\n');
+    double hit = hash + open + load;
+
+    std::printf("%s: %zu bytes, %zu AST nodes, %zu AST bytes, %zu cache bytes, %s, %u threads\n", path.c_str(), bytes, nodes,
+        parser->getASTBytes(), cacheBytes, threads == 1 ? "stream" : "batch", threads);
+    std::printf("%-14s %10s %12s\n", "phase", "ms", "MB/s");
+    std::printf("%-14s %10.2f %12.1f\n", "scan+parse", parse * 1e3, bytes / parse / 1e6);
+    std::printf("%-14s %10.2f %12.1f\n", "write", write * 1e3, cacheBytes / write / 1e6);
+    std::printf("%-14s %10.2f %12.1f\n", "key", hash * 1e3, bytes / hash / 1e6);
+    std::printf("%-14s %10.2f %12.1f\n", "open", open * 1e3, cacheBytes / open / 1e6);
+    std::printf("%-14s %10.2f %12.1f\n", "load", load * 1e3, cacheBytes / load / 1e6);
+    std::printf("%-14s %10.2f %12.1f %8.1fx\n", "hit", hit * 1e3, bytes / hit / 1e6, parse / hit);
+    std::printf("%-14s %10.2f\n", "print parsed", printParsed * 1e3);
+    std::printf("%-14s %10.2f %12s %8.1fx\n", "print cached", printCached * 1e3, "", printParsed / printCached);
+    std::printf("same: %s\n", same);
+
+    unlink(file.c_str());
+    rmdir(dir);
+
+    if (generated) unlink(path.c_str());
+
+    return 0;
+}
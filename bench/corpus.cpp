@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "corpus.h"
+
+Corpus::Corpus(const Options& options) noexcept
+: mOptions {options}
+, mRandom {options.mSeed}
+, mNextVar {0} { }
+
+int Corpus::pick(int lo, int hi) noexcept {
+    return std::uniform_int_distribution<int> {lo, hi}(mRandom);
+}
+
+std::string Corpus::name(char prefix, int n) const {
+    std::string retVal = prefix + std::to_string(n);
+
+    // pad w letters, the digit keeps it from ever being a keyword
+    while (static_cast<int>(retVal.size()) < mOptions.mIdentLength) retVal += static_cast<char>('a' + retVal.size() % 26);
+
+    return retVal;
+}
+
+std::string Corpus::generate() {
+    mText.clear();
+    mArity.clear();
+    mCallable.clear();
+
+    for (int i = 0; i < mOptions.mFunctions || mText.size() < mOptions.mBytes; ++i) {
+        function(name('f', i), pick(0, 3));
+    }
+
+    function("main", 0);
+
+    return mText;
+}
+
+void Corpus::function(const std::string& fname, int arity) {
+    mVars.clear();
+    mNextVar = 0;
+
+    mText += "// " + fname + " takes " + std::to_string(arity) + " args\n";
+    mText += "int " + fname + "(";
+
+    for (int i = 0; i < arity; ++i) {
+        mVars.push_back(name('a', i));
+
+        if (i) mText += ", ";
+
+        mText += "int " + mVars.back();
+    }
+
+    mText += ") {\n";
+
+    statements(mOptions.mStatements, 0, 1);
+
+    mText += "\treturn ";
+    expr(mOptions.mDepth);
+    mText += ";\n}\n\n";
+
+    if (fname == "main") return;
+
+    // only draw for the unused ones when asked to so the default corpus stays the same
+    if (mOptions.mUnused <= 0 || pick(1, 100) > mOptions.mUnused) mCallable.push_back(mArity.size());
+
+    mArity.push_back(arity);
+}
+
+void Corpus::statements(int count, int depth, int indent) {
+    // variables declared in a block go out of scope at its end
+    std::size_t vars = mVars.size();
+
+    for (int i = 0; i < count; ++i) statement(depth, indent);
+
+    mVars.resize(vars);
+}
+
+Corpus::Stmt Corpus::pickStmt(int depth) noexcept {
+    // blocks only nest a couple of levels
+    int nest = depth < 2 ? 1 : 0;
+    int weights[] = {mOptions.mDecl, mOptions.mAssign, mOptions.mIf * nest, mOptions.mWhile * nest, mOptions.mCall, mOptions.mPrint};
+    int total = 0;
+
+    for (int w : weights) total += w;
+
+    // everything weighted out so just declare
+    if (total <= 0) return Stmt::Decl;
+
+    int n = pick(1, total);
+    int i = 0;
+
+    while (n > weights[i]) n -= weights[i++];
+
+    return static_cast<Stmt>(i);
+}
+
+void Corpus::statement(int depth, int tabs) {
+    std::size_t start = mText.size();
+    Stmt kind = pickStmt(depth);
+
+    // the rest all need a variable to work w
+    if (mVars.empty() || (kind == Stmt::Call && mCallable.empty())) kind = Stmt::Decl;
+
+    indent(tabs);
+
+    std::string var = mVars.empty() ? std::string() : mVars[pick(0, mVars.size() - 1)];
+
+    switch (kind) {
+        case Stmt::Decl:
+            mText += "int ";
+            mText += name('v', mNextVar++);
+            mText += " = ";
+            expr(mOptions.mDepth);
+            mText += ";\n";
+
+            mVars.push_back(name('v', mNextVar - 1));
+            break;
+        case Stmt::Assign:
+            mText += var;
+            mText += pick(0, 3) ? " = " : " += ";
+            expr(mOptions.mDepth);
+            mText += ";\n";
+            break;
+        case Stmt::If:
+            mText += "if (";
+            expr(mOptions.mDepth);
+            mText += ") {\n";
+            statements(std::max(1, mOptions.mStatements / 3), depth + 1, tabs + 1);
+            indent(tabs);
+
+            if (pick(0, 1)) {
+                mText += "} else {\n";
+                statements(std::max(1, mOptions.mStatements / 3), depth + 1, tabs + 1);
+                indent(tabs);
+            }
+
+            mText += "}\n";
+            break;
+        case Stmt::While:
+            mText += "while (" + var + " < " + std::to_string(pick(1, 100)) + ") {\n";
+            indent(tabs + 1);
+            mText += "++" + var + ";\n";
+            statements(std::max(1, mOptions.mStatements / 3), depth + 1, tabs + 1);
+            indent(tabs);
+            mText += "}\n";
+            break;
+        case Stmt::Call:
+            mText += var + " = ";
+            call(mOptions.mDepth - 1);
+            mText += ";\n";
+            break;
+        case Stmt::Print:
+            mText += "printf(\"" + var + " = %d\\n\", ";
+            expr(mOptions.mDepth);
+            mText += ");\n";
+            break;
+    }
+
+    if (mOptions.mBroken > 0 && pick(1, 1000) <= mOptions.mBroken) breakStatement(start);
+}
+
+// splice a token that doesnt belong somewhere into the statement that starts at start
+void Corpus::breakStatement(std::size_t start) {
+    static const char * const junk[] = {" ) ", " ( ", " ; ", " = ", " + ", " $ ", " int ", " else ", " ] ", " , "};
+
+    std::size_t at = start + pick(0, mText.size() - start - 1);
+
+    mText.insert(at, junk[pick(0, sizeof(junk) / sizeof(junk[0]) - 1)]);
+}
+
+void Corpus::expr(int depth) {
+    static const char * const ops[] = {" + ", " - ", " * ", " / ", " % ", " < ", " > ", " <= ", " >= ", " == ", " != ", " && ", " || "};
+
+    // leaf
+    if (depth <= 0 || pick(0, 3) == 0) {
+        int leaf = pick(0, 7);
+
+        if (leaf == 0 && !mCallable.empty() && depth > 0) call(depth - 1);
+        else if (leaf < 4 && !mVars.empty()) mText += mVars[pick(0, mVars.size() - 1)];
+        else mText += std::to_string(pick(0, 999));
+
+        return;
+    }
+
+    switch (pick(0, 7)) {
+        case 0:
+            mText += "!(";
+            expr(depth - 1);
+            mText += ")";
+            break;
+        case 1:
+        case 2:
+            mText += "(";
+            expr(depth - 1);
+            mText += ops[pick(0, 12)];
+            expr(depth - 1);
+            mText += ")";
+            break;
+        default:
+            expr(depth - 1);
+            mText += ops[pick(0, 12)];
+            expr(depth - 1);
+            break;
+    }
+}
+
+void Corpus::call(int depth) {
+    int callee = mCallable[pick(0, mCallable.size() - 1)];
+
+    mText += name('f', callee) + "(";
+
+    for (int i = 0; i < mArity[callee]; ++i) {
+        if (i) mText += ", ";
+
+        expr(depth);
+    }
+
+    mText += ")";
+}
+
+void Corpus::indent(int n) {
+    mText.append(n, '\t');
+}
+
+bool Corpus::parseArg(Options& options, const char * arg) noexcept {
+    struct Knob {
+        const char * mName;
+        int Options::* mField;
+    };
+
+    static const Knob knobs[] = {
+        {"--functions=", &Options::mFunctions}, {"--statements=", &Options::mStatements}, {"--depth=", &Options::mDepth},
+        {"--ident-length=", &Options::mIdentLength}, {"--decl=", &Options::mDecl}, {"--assign=", &Options::mAssign},
+        {"--if=", &Options::mIf}, {"--while=", &Options::mWhile}, {"--call=", &Options::mCall}, {"--print=", &Options::mPrint},
+        {"--broken=", &Options::mBroken}, {"--unused=", &Options::mUnused}
+    };
+
+    for (const Knob& knob : knobs) {
+        std::size_t length = std::strlen(knob.mName);
+
+        if (std::strncmp(arg, knob.mName, length) == 0) {
+            options.*knob.mField = std::atoi(arg + length);
+            return true;
+        }
+    }
+
+    if (std::strncmp(arg, "--size=", 7) == 0) {
+        // allow a k/m suffix
+        char * end = nullptr;
+        options.mBytes = std::strtoull(arg + 7, &end, 10);
+
+        if (*end == 'k' || *end == 'K') options.mBytes <<= 10;
+        else if (*end == 'm' || *end == 'M') options.mBytes <<= 20;
+
+        return true;
+    }
+
+    if (std::strncmp(arg, "--seed=", 7) == 0) {
+        options.mSeed = std::strtoul(arg + 7, nullptr, 10);
+        return true;
+    }
+
+    return false;
+}
+
+const char * Corpus::usage() noexcept {
+    return
+        "corpus options:\n"
+        "  --functions=N      number of functions before main (1000)\n"
+        "  --size=N[k|m]      keep adding functions until the source is N bytes (0)\n"
+        "  --statements=N     statements per function body (12)\n"
+        "  --depth=N          max expression depth (3)\n"
+        "  --ident-length=N   identifier length (6)\n"
+        "  --decl=W --assign=W --if=W --while=W --call=W --print=W\n"
+        "                     statement mix weights (4 4 2 1 2 1)\n"
+        "  --broken=N         statements out of 1000 given a syntax error (0)\n"
+        "  --unused=N         percent of the functions nothing calls (0)\n"
+        "  --seed=N           random seed (1)\n";
+}
+
+std::string Corpus::writeTemp(const std::string& text) {
+    char path[] = "/tmp/crispCorpusXXXXXX";
+    int fd = mkstemp(path);
+
+    if (fd == -1) {
+        std::perror("mkstemp");
+        std::exit(1);
+    }
+
+    if (write(fd, text.data(), text.size()) != static_cast<ssize_t>(text.size())) {
+        std::perror("write");
+        std::exit(1);
+    }
+
+    close(fd);
+
+    return path;
+}
@@ -0,0 +1,103 @@
+/*
+defines the synthetic crisp source generator the benchmarks run on i.e. class Corpus
+
+the generated programs are well formed crisp (they parse w/o errors unless mBroken is set) but they are meant for
+the front end only, loops are not guaranteed to terminate so dont run them
+*/
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+class Corpus {
+public:
+    // knobs for the generated source, all of them can be set from the command line w --name=value
+    struct Options {
+        // number of functions (before main)
+        int mFunctions = 1000;
+
+        // keep adding functions until the source is at least this many bytes (0 -> just mFunctions)
+        std::size_t mBytes = 0;
+
+        // statements in each function body (nested blocks get a third of it)
+        int mStatements = 12;
+
+        // max depth of an expression tree
+        int mDepth = 3;
+
+        // length of the generated identifiers (at least long enough to be unique)
+        int mIdentLength = 6;
+
+        // relative weights of the statement kinds
+        int mDecl = 4;
+        int mAssign = 4;
+        int mIf = 2;
+        int mWhile = 1;
+        int mCall = 2;
+        int mPrint = 1;
+
+        // statements out of every 1000 that get a stray token spliced in to exercise error recovery
+        int mBroken = 0;
+
+        // percent of the functions that are never called, like a helper library that is mostly unused
+        int mUnused = 0;
+
+        unsigned mSeed = 1;
+    };
+
+    Corpus(const Options& options) noexcept;
+
+    // the whole program ending in main
+    std::string generate();
+
+    // parses one --name=value argument into options, false if it isnt one
+    static bool parseArg(Options& options, const char * arg) noexcept;
+
+    // the help text for the options above
+    static const char * usage() noexcept;
+
+    // writes text to a new temp file and returns its path (exits on failure)
+    static std::string writeTemp(const std::string& text);
+private:
+    enum class Stmt { Decl, Assign, If, While, Call, Print };
+
+    Options mOptions;
+    std::mt19937 mRandom;
+
+    // the source so far
+    std::string mText;
+
+    // arg counts of the functions generated so far
+    std::vector<int> mArity;
+
+    // the ones of those a call can pick
+    std::vector<int> mCallable;
+
+    // variables visible in the current function
+    std::vector<std::string> mVars;
+
+    // counter to keep identifiers unique within a function
+    int mNextVar;
+
+    // random int in [lo, hi]
+    int pick(int lo, int hi) noexcept;
+
+    // identifier w prefix and number padded to the requested length
+    std::string name(char prefix, int n) const;
+
+    void function(const std::string& name, int arity);
+    void statements(int count, int depth, int indent);
+    void statement(int depth, int indent);
+    void breakStatement(std::size_t start);
+    void expr(int depth);
+    void call(int depth);
+    void indent(int n);
+
+    Stmt pickStmt(int depth) noexcept;
+};
+
+#endif
@@ -0,0 +1,180 @@
+/*
+stress test for deeply nested input, the parser and the IR emitter are run on programs that repeat one construct
+depth times
+
+usage: depthBench [--depth=N] [--max-depth=N] [--engine=descent|pratt] [--reps=N]
+
+    chain:   x = x + 1 - 2 + ... a flat chain of depth operators
+    logic:   the same w || and &&
+    elseif:  if (x == 0) ... else if (x == 1) ... an else if chain depth links long
+    blocks:  depth blocks nested in each other, once w the default budget (past it so a diagnostic) and once
+             w --max-depth (default depth + 16)
+    parens:  x = ((( ... x ... ))) depth parentheses deep, past the default budget so a diagnostic
+
+none of them may crash, each one reports the best parse time of reps runs, the time to emit the IR (if it parsed
+w/o errors) and whether it verifies, the number of errors and the first one
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "../scan/scan.h"
+#include "../parse/parse.h"
+#include "../parse/symbols.h"
+#include "../emitIR/emitter.h"
+#include "corpus.h"
+
+// int main() w x declared around body
+static std::string program(const std::string& body) {
+    return "int main() {\n\tint x = 0;\n" + body + "\treturn x;\n}\n";
+}
+
+// x = x a 1 b 2 a 3 ... w depth operators
+static std::string chain(int depth, const char * a, const char * b) {
+    std::string stmt = "\tx = x";
+
+    for (int i = 0; i < depth; ++i) stmt += (i % 2 ? b : a) + std::to_string(i % 97 + 1);
+
+    return program(stmt + ";\n");
+}
+
+static std::string elseIf(int depth) {
+    std::string body = "\tif (x == 0) x = 1;\n";
+
+    for (int i = 1; i < depth; ++i) body += "\telse if (x == " + std::to_string(i) + ") x = " + std::to_string(i + 1) + ";\n";
+
+    return program(body + "\telse x = 0;\n");
+}
+
+// each block declares its own y so nothing is looked up through the scopes around it
+static std::string blocks(int depth) {
+    std::string body;
+
+    for (int i = 0; i < depth; ++i) body += "{ int y = 1;\n";
+
+    return program(body + std::string(depth, '}') + "\n");
+}
+
+static std::string parens(int depth) {
+    return program("\tx = " + std::string(depth, '(') + "x + 1" + std::string(depth, ')') + ";\n");
+}
+
+struct Result {
+    double mParse;
+    double mEmit;
+    bool mVerified;
+    int mErrors;
+    std::string mFirstError;
+};
+
+static Result run(const char * path, Parser::ExprEngine engine, unsigned maxDepth, int reps) {
+    Result result {1e30, -1, false, 0, {}};
+    std::ostream discard {nullptr};
+
+    for (int i = 0; i < reps; ++i) {
+        Scanner scanner {path};
+        scanner.scanTokens();
+
+        SymbolTable symTable {};
+        StringTable strTable {};
+        std::ostringstream errors;
+
+        Parser::Options options;
+        options.mEngine = engine;
+        options.mMaxDepth = maxDepth;
+
+        auto start = std::chrono::steady_clock::now();
+
+        Parser parser {scanner, symTable, strTable, path, &errors, &discard, options};
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (elapsed.count() < result.mParse) result.mParse = elapsed.count();
+
+        if (i > 0) continue;
+
+        result.mErrors = parser.getNumErrors();
+
+        // just the message of the first one
+        std::string text = errors.str();
+        std::size_t at = text.find("error: ");
+
+        if (at != std::string::npos) result.mFirstError = text.substr(at + 7, text.find('\n', at) - at - 7);
+
+        if (!parser.isValid()) continue;
+
+        start = std::chrono::steady_clock::now();
+
+        Emitter emit {parser};
+
+        elapsed = std::chrono::steady_clock::now() - start;
+        result.mEmit = elapsed.count();
+        result.mVerified = emit.verify();
+    }
+
+    return result;
+}
+
+static int usage() {
+    std::fprintf(stderr, "usage: depthBench [--depth=N] [--max-depth=N] [--engine=descent|pratt] [--reps=N]\n");
+    return 1;
+}
+
+int main(int argc, char * argv[]) {
+    int depth = 100000;
+    unsigned maxDepth = 0;
+    Parser::ExprEngine engine = Parser::ExprEngine::Pratt;
+    int reps = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        const char * arg = argv[i];
+
+        if (std::strncmp(arg, "--depth=", 8) == 0) depth = std::max(1, std::atoi(arg + 8));
+        else if (std::strncmp(arg, "--max-depth=", 12) == 0) maxDepth = std::max(1, std::atoi(arg + 12));
+        else if (std::strcmp(arg, "--engine=descent") == 0) engine = Parser::ExprEngine::Descent;
+        else if (std::strcmp(arg, "--engine=pratt") == 0) engine = Parser::ExprEngine::Pratt;
+        else if (std::strncmp(arg, "--reps=", 7) == 0) reps = std::max(1, std::atoi(arg + 7));
+        else return usage();
+    }
+
+    // room for the blocks plus the function body and the statements in the innermost one
+    if (maxDepth == 0) maxDepth = depth + 16;
+
+    struct Input {
+        const char * mName;
+        std::string mText;
+        unsigned mMaxDepth;
+    };
+
+    Input inputs[] = {
+        {"chain", chain(depth, " + ", " - "), Parser::DefaultMaxDepth},
+        {"logic", chain(depth, " || ", " && "), Parser::DefaultMaxDepth},
+        {"elseif", elseIf(depth), Parser::DefaultMaxDepth},
+        {"blocks", blocks(depth), Parser::DefaultMaxDepth},
+        {"blocks", blocks(depth), maxDepth},
+        {"parens", parens(depth), Parser::DefaultMaxDepth}
+    };
+
+    std::printf("%-8s %8s %10s %10s %10s %8s %8s  %s\n", "input", "depth", "max-depth", "parse ms", "emit ms", "verified", "errors", "first error");
+
+    for (const Input& input : inputs) {
+        std::string temp = Corpus::writeTemp(input.mText);
+
+        Result r = run(temp.c_str(), engine, input.mMaxDepth, reps);
+
+        if (r.mEmit < 0) {
+            std::printf("%-8s %8d %10u %10.2f %10s %8s %8d  %s\n", input.mName, depth, input.mMaxDepth, r.mParse * 1e3, "-", "-", r.mErrors, r.mFirstError.c_str());
+        } else {
+            std::printf("%-8s %8d %10u %10.2f %10.2f %8s %8d  %s\n", input.mName, depth, input.mMaxDepth, r.mParse * 1e3, r.mEmit * 1e3, r.mVerified ? "yes" : "NO", r.mErrors, r.mFirstError.c_str());
+        }
+
+        unlink(temp.c_str());
+    }
+
+    return 0;
+}
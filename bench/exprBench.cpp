@@ -0,0 +1,184 @@
+/*
+benchmark for the expression parser, recursive descent vs Pratt (Parser::ExprEngine)
+
+usage: exprBench [--nesting=N] [--chain=N] [--reps=N] [corpus options] [file.crisp]
+
+parses three sources (or just the given file) w both engines on pre-scanned tokens:
+    corpus: a generated program (see corpus.h)
+    deep:   statements whose expression nests N parentheses deep
+    chain:  statements w a flat chain of N binary operators mixing every precedence level
+
+and reports the best of reps runs along w the calls made through the precedence levels per expression, each
+Pratt tree is also checked to print exactly like the recursive descent one
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "../scan/scan.h"
+#include "../parse/astNodes.h"
+#include "../parse/parse.h"
+#include "../parse/symbols.h"
+#include "corpus.h"
+
+#ifndef CRISP_PARSE_STATS
+#error "exprBench reads the parser counters, build it through bench/Makefile which defines CRISP_PARSE_STATS"
+#endif
+
+static const char * const sOps[] = {" + ", " * ", " - ", " < ", " / ", " == ", " % ", " && ", " != ", " || ", " >= "};
+static const std::size_t NumOps = sizeof(sOps) / sizeof(sOps[0]);
+
+// main w statements of the form x = (((x + 1) * 2) - 3) ... nesting deep until the source is about bytes long
+static std::string deep(int nesting, std::size_t bytes) {
+    std::string stmt = "\tx = " + std::string(nesting, '(') + "x";
+
+    for (int i = 0; i < nesting; ++i) stmt += sOps[i % NumOps] + std::to_string(i % 97 + 1) + ")";
+
+    stmt += ";\n";
+
+    std::string text = "int main() {\n\tint x = 1;\n";
+
+    while (text.size() < bytes) text += stmt;
+
+    return text + "\treturn x;\n}\n";
+}
+
+// same but x = x + 1 * 2 - 3 < ... w length operators and no parentheses
+static std::string chain(int length, std::size_t bytes) {
+    std::string stmt = "\tx = x";
+
+    for (int i = 0; i < length; ++i) stmt += sOps[i % NumOps] + std::to_string(i % 97 + 1);
+
+    stmt += ";\n";
+
+    std::string text = "int main() {\n\tint x = 1;\n";
+
+    while (text.size() < bytes) text += stmt;
+
+    return text + "\treturn x;\n}\n";
+}
+
+struct Result {
+    double mTime;
+    std::size_t mExprs;
+    std::size_t mCalls;
+    int mErrors;
+    std::string mTree;
+};
+
+static Result run(const char * path, Parser::ExprEngine engine, unsigned maxDepth, int reps) {
+    Result result {1e30, 0, 0, 0, {}};
+    std::ostream discard {nullptr};
+
+    for (int i = 0; i < reps; ++i) {
+        Scanner scanner {path};
+        scanner.scanTokens();
+
+        SymbolTable symTable {};
+        StringTable strTable {};
+
+        Parser::Options options;
+        options.mEngine = engine;
+        options.mMaxDepth = maxDepth;
+
+        auto start = std::chrono::steady_clock::now();
+
+        Parser parser {scanner, symTable, strTable, path, &discard, &discard, options};
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (elapsed.count() < result.mTime) result.mTime = elapsed.count();
+
+        if (i == 0) {
+            result.mExprs = parser.getExprCount();
+            result.mCalls = parser.getExprCalls();
+            result.mErrors = parser.getNumErrors();
+
+            if (parser.getRoot()) {
+                std::ostringstream tree;
+                parser.getRoot()->printNode(tree);
+                result.mTree = tree.str();
+            }
+        }
+    }
+
+    return result;
+}
+
+static void compare(const char * name, const std::string& path, unsigned maxDepth, int reps) {
+    std::size_t bytes = SourceBuffer(path.c_str()).length();
+
+    Result descent = run(path.c_str(), Parser::ExprEngine::Descent, maxDepth, reps);
+    Result pratt = run(path.c_str(), Parser::ExprEngine::Pratt, maxDepth, reps);
+
+    const char * same = descent.mTree == pratt.mTree && descent.mErrors == pratt.mErrors ? "yes" : "NO";
+
+    for (const Result * r : {&descent, &pratt}) {
+        std::printf("%-8s %-8s %10.2f %10.1f %14.0f %12.2f %8d %6s\n", name, r == &descent ? "descent" : "pratt", r->mTime * 1e3,
+            bytes / r->mTime / 1e6, r->mExprs / r->mTime, static_cast<double>(r->mCalls) / std::max<std::size_t>(1, r->mExprs), r->mErrors, same);
+    }
+
+    std::printf("%-8s %-8s %10.2fx\n", name, "speedup", descent.mTime / pratt.mTime);
+}
+
+static int usage() {
+    std::fprintf(stderr, "usage: exprBench [--nesting=N] [--chain=N] [--reps=N] [options] [file.crisp]\n%s", Corpus::usage());
+    return 1;
+}
+
+int main(int argc, char * argv[]) {
+    Corpus::Options options;
+    options.mBytes = 4 << 20;
+
+    int nesting = 500;
+    int length = 200;
+    int reps = 5;
+    std::string path;
+
+    for (int i = 1; i < argc; ++i) {
+        const char * arg = argv[i];
+
+        if (std::strncmp(arg, "--nesting=", 10) == 0) nesting = std::max(1, std::atoi(arg + 10));
+        else if (std::strncmp(arg, "--chain=", 8) == 0) length = std::max(1, std::atoi(arg + 8));
+        else if (std::strncmp(arg, "--reps=", 7) == 0) reps = std::max(1, std::atoi(arg + 7));
+        else if (Corpus::parseArg(options, arg));
+        else if (arg[0] != '-' && path.empty()) path = arg;
+        else return usage();
+    }
+
+    // deep nests past the default budget of the parser on purpose
+    unsigned maxDepth = std::max<unsigned>(Parser::DefaultMaxDepth, nesting + 16);
+
+    std::printf("%-8s %-8s %10s %10s %14s %12s %8s %6s\n", "input", "engine", "ms", "MB/s", "exprs/s", "calls/expr", "errors", "same");
+
+    if (!path.empty()) {
+        compare("file", path, maxDepth, reps);
+        return 0;
+    }
+
+    struct Input {
+        const char * mName;
+        std::string mText;
+    };
+
+    Input inputs[] = {
+        {"corpus", Corpus(options).generate()},
+        {"deep", deep(nesting, options.mBytes)},
+        {"chain", chain(length, options.mBytes)}
+    };
+
+    for (const Input& input : inputs) {
+        std::string temp = Corpus::writeTemp(input.mText);
+
+        compare(input.mName, temp, maxDepth, reps);
+
+        unlink(temp.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+/*
+writes a synthetic crisp corpus (see corpus.h) to a file or stdout
+
+usage: genCorpus [corpus options] [out.crisp]
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "corpus.h"
+
+int main(int argc, char * argv[]) {
+    Corpus::Options options;
+    const char * out = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (Corpus::parseArg(options, argv[i])) continue;
+
+        if (argv[i][0] == '-' || out) {
+            std::fprintf(stderr, "usage: genCorpus [options] [out.crisp]\n%s", Corpus::usage());
+            return 1;
+        }
+
+        out = argv[i];
+    }
+
+    std::string text = Corpus(options).generate();
+
+    if (!out) {
+        std::cout << text;
+        return 0;
+    }
+
+    std::ofstream file(out, std::ios::binary);
+    file << text;
+
+    if (!file) {
+        std::perror(out);
+        return 1;
+    }
+
+    std::fprintf(stderr, "%s: %zu bytes\n", out, text.size());
+
+    return 0;
+}
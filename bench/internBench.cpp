@@ -0,0 +1,194 @@
+/*
+contention benchmark for the concurrent string interner (see ../scan/interner.h)
+
+usage: internBench [--reps=N] [--max-threads=N] [corpus options] [file.crisp]
+
+the identifier spellings of the file (or of a corpus generated from the options, see corpus.h) are split into as many
+contiguous runs as there are threads, the way the bodies of a parallel parse are, and every thread interns each
+spelling of its run into one shared table. the same work is timed w 1, 2, 4, ... max threads (64 by default) for:
+    interner:  Interner, lookups w/o a lock and inserts that lock one shard
+    shared:    an unordered_map behind a std::shared_mutex, lookups share the lock
+    mutex:     an unordered_map behind a std::mutex, the way StringTable used to be
+reports the best of reps runs of each as millions of interns a second, each run starts from an empty table. every
+thread also sums the ids it got back and the sums have to match the ids the table holds once the run is over
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include "../scan/interner.h"
+#include "../scan/scan.h"
+#include "corpus.h"
+
+// the old tables, each string gets the next id the first time it is seen
+template <typename Mutex, typename Shared>
+class MapTable {
+public:
+    std::uint32_t intern(std::string_view text) {
+        {
+            Shared lock {mLock};
+
+            auto found = mIds.find(text);
+
+            if (found != mIds.end()) return found->second;
+        }
+
+        std::lock_guard<Mutex> lock {mLock};
+
+        auto found = mIds.find(text);
+
+        if (found != mIds.end()) return found->second;
+
+        mText.emplace_back(text);
+
+        return mIds.emplace(mText.back(), mIds.size()).first->second;
+    }
+
+    std::uint32_t find(std::string_view text) {
+        auto found = mIds.find(text);
+
+        return found != mIds.end() ? found->second : UINT32_MAX;
+    }
+private:
+    Mutex mLock;
+    std::unordered_map<std::string_view, std::uint32_t> mIds;
+    std::deque<std::string> mText;
+};
+
+using SharedTable = MapTable<std::shared_mutex, std::shared_lock<std::shared_mutex>>;
+using MutexTable = MapTable<std::mutex, std::lock_guard<std::mutex>>;
+
+// best time of reps runs of interning words on threads, same is set to false if a thread got a wrong id
+template <typename Table>
+static double run(const std::vector<std::string_view>& words, unsigned threads, int reps, bool& same, std::size_t& distinct) {
+    double best = 1e30;
+
+    for (int rep = 0; rep < reps; ++rep) {
+        std::unique_ptr<Table> table {new Table()};
+        std::vector<std::uint64_t> sums(threads, 0);
+        std::vector<std::thread> pool;
+
+        auto work = [&](unsigned t) {
+            std::size_t first = words.size() * t / threads;
+            std::size_t last = words.size() * (t + 1) / threads;
+            std::uint64_t sum = 0;
+
+            for (std::size_t i = first; i < last; ++i) sum += table->intern(words[i]);
+
+            sums[t] = sum;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work, t);
+
+        work(0);
+
+        for (std::thread& thread : pool) thread.join();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+
+        // every id a thread got has to be the one the table ended up w
+        std::vector<std::uint32_t> ids;
+
+        for (unsigned t = 0; t < threads; ++t) {
+            std::size_t first = words.size() * t / threads;
+            std::size_t last = words.size() * (t + 1) / threads;
+            std::uint64_t sum = 0;
+
+            for (std::size_t i = first; i < last; ++i) {
+                std::uint32_t id = table->find(words[i]);
+
+                sum += id;
+                ids.push_back(id);
+            }
+
+            same = same && sum == sums[t];
+        }
+
+        // and the ids have to be dense
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        distinct = ids.size();
+        same = same && (ids.empty() || ids.back() == ids.size() - 1);
+    }
+
+    return best;
+}
+
+static int usage() {
+    std::fprintf(stderr, "usage: internBench [--reps=N] [--max-threads=N] [options] [file.crisp]\n%s", Corpus::usage());
+    return 1;
+}
+
+int main(int argc, char * argv[]) {
+    Corpus::Options options;
+    options.mBytes = 8 << 20;
+
+    int reps = 3;
+    unsigned maxThreads = 64;
+    std::string path;
+
+    for (int i = 1; i < argc; ++i) {
+        const char * arg = argv[i];
+
+        if (std::strncmp(arg, "--reps=", 7) == 0) reps = std::max(1, std::atoi(arg + 7));
+        else if (std::strncmp(arg, "--max-threads=", 14) == 0) maxThreads = std::max(1, std::atoi(arg + 14));
+        else if (Corpus::parseArg(options, arg));
+        else if (arg[0] != '-' && path.empty()) path = arg;
+        else return usage();
+    }
+
+    bool generated = path.empty();
+
+    if (generated) path = Corpus::writeTemp(Corpus(options).generate());
+
+    // the spellings are views into the source so the scanner is kept around
+    Scanner scanner {path.c_str()};
+    std::vector<std::string_view> words;
+
+    scanner.streamTokens();
+
+    for (Token token = scanner.token(); token.type() != TokenType::EndOfFile; scanner.nextToken(), token = scanner.token()) {
+        if (token.type() == TokenType::Identifier) words.push_back(token.text());
+    }
+
+    std::size_t distinct = 0;
+    bool same = true;
+
+    run<Interner<>>(words, 1, 1, same, distinct);
+
+    std::printf("%s: %zu identifiers, %zu distinct, %u cores\n", path.c_str(), words.size(), distinct, std::thread::hardware_concurrency());
+    std::printf("%8s %12s %12s %12s %10s %6s\n", "threads", "interner", "shared", "mutex", "speedup", "same");
+
+    double serial = 0;
+
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        double interner = run<Interner<>>(words, threads, reps, same, distinct);
+        double shared = run<SharedTable>(words, threads, reps, same, distinct);
+        double mutex = run<MutexTable>(words, threads, reps, same, distinct);
+
+        if (threads == 1) serial = interner;
+
+        // millions of interns a second, speedup of the interner over itself on one thread
+        std::printf("%8u %12.1f %12.1f %12.1f %10.2f %6s\n", threads, words.size() / interner / 1e6, words.size() / shared / 1e6,
+            words.size() / mutex / 1e6, serial / interner, same ? "yes" : "NO");
+    }
+
+    if (generated) unlink(path.c_str());
+
+    return 0;
+}
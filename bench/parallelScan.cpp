@@ -0,0 +1,93 @@
+/*
+benchmark for Scanner::scanTokensParallel
+
+usage: parallelScan [file.crisp] [reps]
+
+scans the file serially and then w 2, 4, ... threads (up to twice the core count) and reports throughput and the
+speedup over the serial scanner, each parallel run is also checked to produce exactly the serial tokens
+w/o a file a synthetic ~32 MB corpus (see corpus.h) is generated into a temp file
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "../scan/scan.h"
+#include "corpus.h"
+
+// true if both scanners hold the same tokens
+static bool same(Scanner& a, Scanner& b) {
+    for (;;) {
+        Token x = a.token(), y = b.token();
+
+        if (x.type() != y.type() || x.offset() != y.offset() || x.text() != y.text()) return false;
+        if (x.type() == TokenType::EndOfFile) break;
+
+        a.nextToken();
+        b.nextToken();
+    }
+
+    for (std::size_t line = 1; line <= a.lines().size(); ++line) {
+        if (line > b.lines().size() || a.lines().start(line) != b.lines().start(line)) return false;
+    }
+
+    return a.lines().size() == b.lines().size();
+}
+
+// best time in seconds of reps runs of scanning path w threads (0 -> serial scanTokens)
+static double run(const char * path, unsigned threads, int reps, std::size_t& tokens) {
+    double best = 1e30;
+
+    for (int i = 0; i < reps; ++i) {
+        Scanner scanner {path};
+
+        auto start = std::chrono::steady_clock::now();
+
+        if (threads == 0) scanner.scanTokens();
+        else scanner.scanTokensParallel(threads);
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (elapsed.count() < best) best = elapsed.count();
+
+        tokens = scanner.tokenCount();
+    }
+
+    return best;
+}
+
+int main(int argc, char * argv[]) {
+    Corpus::Options options;
+    options.mBytes = 32 << 20;
+
+    std::string path = argc > 1 ? argv[1] : Corpus::writeTemp(Corpus(options).generate());
+    int reps = argc > 2 ? std::atoi(argv[2]) : 5;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::size_t bytes = SourceBuffer(path.c_str()).length();
+    std::size_t tokens = 0;
+
+    double serial = run(path.c_str(), 0, reps, tokens);
+
+    std::printf("%s: %zu bytes, %zu tokens, %u cores\n", path.c_str(), bytes, tokens, cores);
+    std::printf("%8s %10s %12s %14s %8s %6s\n", "threads", "ms", "MB/s", "tokens/s", "speedup", "same");
+    std::printf("%8s %10.2f %12.1f %14.0f %8.2f %6s\n", "serial", serial * 1e3, bytes / serial / 1e6, tokens / serial, 1.0, "-");
+
+    for (unsigned threads = 2; threads <= 2 * cores || threads <= 2; threads *= 2) {
+        double time = run(path.c_str(), threads, reps, tokens);
+
+        Scanner a {path.c_str()}, b {path.c_str()};
+
+        a.scanTokens();
+        b.scanTokensParallel(threads);
+
+        std::printf("%8u %10.2f %12.1f %14.0f %8.2f %6s\n", threads, time * 1e3, bytes / time / 1e6, tokens / time, serial / time, same(a, b) ? "yes" : "NO");
+    }
+
+    if (argc < 2) unlink(path.c_str());
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+benchmark for the parser alone
+
+usage: parseBench [--mode=batch|stream] [--reps=N] [--threads=N] [--lazy] [corpus options] [file.crisp]
+
+batch: the tokens are scanned up front and only the Parser is timed
+stream: the scanner is pulled by the parser so the time covers both (the way crisp runs)
+--threads=N parses the function bodies on N threads (0 -> one per core, batch only)
+--lazy only keeps the functions reachable from main, the others are skipped (w/o being parsed in batch mode)
+
+reports the best of reps runs as tokens/sec, bytes/sec and AST nodes/sec along w the heap allocations made while
+parsing and the size of the AST arena, nodes are counted by printing the tree (one line per node) outside the timed region
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../scan/scan.h"
+#include "../parse/astNodes.h"
+#include "../parse/parse.h"
+#include "../parse/symbols.h"
+#include "allocCount.h"
+#include "corpus.h"
+
+// streambuf that throws away the output but counts its lines
+class LineCounter : public std::streambuf {
+public:
+    std::size_t mLines = 0;
+protected:
+    int overflow(int c) override {
+        if (c == '\n') ++mLines;
+
+        return c;
+    }
+};
+
+static int usage() {
+    std::fprintf(stderr, "usage: parseBench [--mode=batch|stream] [--reps=N] [--threads=N] [--lazy] [options] [file.crisp]\n%s", Corpus::usage());
+    return 1;
+}
+
+int main(int argc, char * argv[]) {
+    Corpus::Options options;
+    options.mBytes = 8 << 20;
+
+    bool streaming = false;
+    int reps = 5;
+    unsigned threads = 1;
+    bool lazy = false;
+    std::string path;
+
+    for (int i = 1; i < argc; ++i) {
+        const char * arg = argv[i];
+
+        if (std::strcmp(arg, "--mode=batch") == 0) streaming = false;
+        else if (std::strcmp(arg, "--mode=stream") == 0) streaming = true;
+        else if (std::strncmp(arg, "--reps=", 7) == 0) reps = std::max(1, std::atoi(arg + 7));
+        else if (std::strncmp(arg, "--threads=", 10) == 0) threads = std::max(0, std::atoi(arg + 10));
+        else if (std::strcmp(arg, "--lazy") == 0) lazy = true;
+        else if (Corpus::parseArg(options, arg));
+        else if (arg[0] != '-' && path.empty()) path = arg;
+        else return usage();
+    }
+
+    bool generated = path.empty();
+
+    if (generated) path = Corpus::writeTemp(Corpus(options).generate());
+
+    std::size_t bytes = SourceBuffer(path.c_str()).length();
+    std::size_t tokens = 0;
+    std::size_t nodes = 0;
+    std::size_t allocs = 0;
+    std::size_t allocBytes = 0;
+    std::size_t astBytes = 0;
+    int errors = 0;
+    std::size_t funcs = 0;
+    double best = 1e30;
+
+    // errors are only counted
+    std::ostream discard {nullptr};
+
+    for (int i = 0; i < reps; ++i) {
+        Scanner scanner {path.c_str()};
+
+        if (streaming) {
+            scanner.streamTokens();
+        } else {
+            scanner.scanTokens();
+            tokens = scanner.tokenCount();
+        }
+
+        SymbolTable symTable {};
+        StringTable strTable {};
+
+        Parser::Options options;
+        options.mThreads = threads;
+        if (lazy) options.mRoots.emplace_back("main");
+
+        AllocCount::reset();
+
+        auto start = std::chrono::steady_clock::now();
+
+        Parser parser {scanner, symTable, strTable, path.c_str(), &discard, &discard, options};
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        allocs = AllocCount::count();
+        allocBytes = AllocCount::bytes();
+        errors = parser.getNumErrors();
+        astBytes = parser.getASTBytes();
+
+        if (elapsed.count() < best) best = elapsed.count();
+
+        if (i == 0 && parser.getRoot()) {
+            LineCounter counter;
+            std::ostream out {&counter};
+
+            parser.getRoot()->printNode(out);
+            nodes = counter.mLines;
+            funcs = parser.getRoot()->getFunctions().size();
+        }
+    }
+
+    // the streaming scanner doesnt keep its tokens so count them w a separate scan
+    if (streaming) {
+        Scanner scanner {path.c_str()};
+        scanner.scanTokens();
+        tokens = scanner.tokenCount();
+    }
+
+    std::printf("%s: %zu bytes, %zu tokens, %zu functions, %zu AST nodes, %d errors, %s, %u threads%s\n", path.c_str(), bytes, tokens, funcs, nodes, errors,
+        streaming ? "stream" : "batch", streaming ? 1 : threads, lazy ? ", lazy" : "");
+    std::printf("%10s %12s %14s %14s %10s %14s %14s\n", "ms", "MB/s", "tokens/s", "nodes/s", "allocs", "alloc bytes", "AST bytes");
+    std::printf("%10.2f %12.1f %14.0f %14.0f %10zu %14zu %14zu\n", best * 1e3, bytes / best / 1e6, tokens / best, nodes / best, allocs, allocBytes, astBytes);
+
+    if (generated) unlink(path.c_str());
+
+    return 0;
+}
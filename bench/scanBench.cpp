@@ -0,0 +1,113 @@
+/*
+benchmark for the scanner alone
+
+usage: scanBench [--engine=switch|table] [--mode=batch|stream|parallel] [--threads=N] [--reps=N] [corpus options] [file.crisp]
+
+times scanning the file (or a corpus generated from the options, see corpus.h) and reports the best of reps runs as
+tokens/sec and bytes/sec along w the heap allocations made by the scan
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include "../scan/scan.h"
+#include "allocCount.h"
+#include "corpus.h"
+
+enum class Mode { Batch, Stream, Parallel };
+
+// scans path once and returns the number of tokens including EOF
+static std::size_t scan(const char * path, Scanner::Engine engine, Mode mode, unsigned threads) {
+    Scanner scanner {path, engine};
+
+    switch (mode) {
+        case Mode::Batch:
+            scanner.scanTokens();
+            return scanner.tokenCount();
+        case Mode::Parallel:
+            scanner.scanTokensParallel(threads);
+            return scanner.tokenCount();
+        case Mode::Stream:
+            break;
+    }
+
+    // pull every token through the ring like the parser would
+    std::size_t tokens = 1;
+
+    scanner.streamTokens();
+
+    for (; scanner.token().type() != TokenType::EndOfFile; scanner.nextToken()) ++tokens;
+
+    return tokens;
+}
+
+static int usage() {
+    std::fprintf(stderr, "usage: scanBench [--engine=switch|table] [--mode=batch|stream|parallel] [--threads=N] [--reps=N] [options] [file.crisp]\n%s", Corpus::usage());
+    return 1;
+}
+
+int main(int argc, char * argv[]) {
+    Corpus::Options options;
+    options.mBytes = 32 << 20;
+
+    Scanner::Engine engine = Scanner::Engine::Switch;
+    Mode mode = Mode::Batch;
+    unsigned threads = 0;
+    int reps = 5;
+    std::string path;
+
+    for (int i = 1; i < argc; ++i) {
+        const char * arg = argv[i];
+
+        if (std::strcmp(arg, "--engine=switch") == 0) engine = Scanner::Engine::Switch;
+        else if (std::strcmp(arg, "--engine=table") == 0) engine = Scanner::Engine::Table;
+        else if (std::strcmp(arg, "--mode=batch") == 0) mode = Mode::Batch;
+        else if (std::strcmp(arg, "--mode=stream") == 0) mode = Mode::Stream;
+        else if (std::strcmp(arg, "--mode=parallel") == 0) mode = Mode::Parallel;
+        else if (std::strncmp(arg, "--threads=", 10) == 0) threads = std::max(0, std::atoi(arg + 10));
+        else if (std::strncmp(arg, "--reps=", 7) == 0) reps = std::max(1, std::atoi(arg + 7));
+        else if (Corpus::parseArg(options, arg));
+        else if (arg[0] != '-' && path.empty()) path = arg;
+        else return usage();
+    }
+
+    bool generated = path.empty();
+
+    if (generated) path = Corpus::writeTemp(Corpus(options).generate());
+
+    std::size_t bytes = SourceBuffer(path.c_str()).length();
+    std::size_t tokens = 0;
+    std::size_t allocs = 0;
+    std::size_t allocBytes = 0;
+    double best = 1e30;
+
+    for (int i = 0; i < reps; ++i) {
+        AllocCount::reset();
+
+        auto start = std::chrono::steady_clock::now();
+
+        tokens = scan(path.c_str(), engine, mode, threads);
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        allocs = AllocCount::count();
+        allocBytes = AllocCount::bytes();
+
+        if (elapsed.count() < best) best = elapsed.count();
+    }
+
+    const char * modes[] = {"batch", "stream", "parallel"};
+
+    std::printf("%s: %zu bytes, %zu tokens, %s engine, %s\n", path.c_str(), bytes, tokens,
+        engine == Scanner::Engine::Switch ? "switch" : "table", modes[static_cast<int>(mode)]);
+    std::printf("%10s %12s %14s %10s %14s\n", "ms", "MB/s", "tokens/s", "allocs", "alloc bytes");
+    std::printf("%10.2f %12.1f %14.0f %10zu %14zu\n", best * 1e3, bytes / best / 1e6, tokens / best, allocs, allocBytes);
+
+    if (generated) unlink(path.c_str());
+
+    return 0;
+}
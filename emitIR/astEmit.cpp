@@ -1,6 +1,8 @@
 #include "../parse/astNodes.h"
 #include "emitter.h"
 #include <iostream>
+#include <utility>
+#include <vector>
 // note all llvm headers are in emitter.h
 
 llvm::Value * ASTProg::codegen(CodeContext& ctx) noexcept {
@@ -111,7 +113,7 @@ llvm::Value * ASTFunc::codegen(CodeContext& ctx) noexcept {
     for (int i = 0; iter != end; ++iter, ++i) {
         // llvm arg and ast arg
         llvm::Argument * arg = &(*iter);
-        std::shared_ptr<ASTArgDecl> argDecl = this->mArgs[i];
+        ASTArgDecl * argDecl = this->mArgs[i];
         
         // store alloca value in ident
         Identifier& ident = argDecl->getIdent();
@@ -165,50 +167,102 @@ llvm::Value * ASTDecl::codegen(CodeContext& ctx) noexcept {
 }
 
 llvm::Value * ASTCompoundStmt::codegen(CodeContext& ctx) noexcept {
-    for (auto &x : this->mStmts) x->codegen(ctx);
+    // a block in a block is walked in this loop w the blocks around it on a stack so deep nesting doesnt recurse
+    std::vector<std::pair<ASTCompoundStmt *, std::size_t>> open;
+    ASTCompoundStmt * block = this;
+    std::size_t next = 0;
+
+    for (;;) {
+        if (next == block->mStmts.size()) {
+            if (open.empty()) break;
+
+            block = open.back().first;
+            next = open.back().second;
+            open.pop_back();
+
+            continue;
+        }
+
+        ASTStmt * stmt = block->mStmts[next++];
+
+        if (ASTCompoundStmt * inner = dyn_cast<ASTCompoundStmt>(stmt)) {
+            open.emplace_back(block, next);
+            block = inner;
+            next = 0;
+        } else {
+            stmt->codegen(ctx);
+        }
+    }
 
 	return nullptr;
 }
 
 llvm::Value * ASTIfStmt::codegen(CodeContext& ctx) noexcept {
-    llvm::Value * value = this->mExpr->codegen(ctx);
+    // an else if chain is emitted in this loop instead of recursing into each else, the ifs are opened on the way
+    // down (cond + branch, the else is emitted before the then) and closed on the way back up
+    struct OpenIf {
+        ASTIfStmt * mStmt;
+        llvm::BasicBlock * mThenBody;
+        llvm::BasicBlock * mEnd;
+    };
 
-    llvm::IRBuilder<> builder(ctx.mBlock);
+    std::vector<OpenIf> chain;
 
-    // if not bool type make it so 
-    if (!value->getType()->isIntegerTy(1)) {
-        value = builder.CreateICmpNE(value, llvm::Constant::getNullValue(llvm::IntegerType::getInt32Ty(*ctx.mGlobalContext))); 
-    }
-    
-    llvm::BasicBlock * thenBody = llvm::BasicBlock::Create(*ctx.mGlobalContext, "if.then", ctx.mFunc);
-    llvm::BasicBlock * end = llvm::BasicBlock::Create(*ctx.mGlobalContext, "if.end", ctx.mFunc);
-    llvm::BasicBlock * elseBody;
+    for (ASTIfStmt * stmt = this; stmt; ) {
+        llvm::Value * value = stmt->mExpr->codegen(ctx);
+
+        llvm::IRBuilder<> builder(ctx.mBlock);
+
+        // if not bool type make it so 
+        if (!value->getType()->isIntegerTy(1)) {
+            value = builder.CreateICmpNE(value, llvm::Constant::getNullValue(llvm::IntegerType::getInt32Ty(*ctx.mGlobalContext))); 
+        }
+        
+        llvm::BasicBlock * thenBody = llvm::BasicBlock::Create(*ctx.mGlobalContext, "if.then", ctx.mFunc);
+        llvm::BasicBlock * end = llvm::BasicBlock::Create(*ctx.mGlobalContext, "if.end", ctx.mFunc);
+        llvm::BasicBlock * elseBody;
 
-    if (mElseStmt) {
-        elseBody = llvm::BasicBlock::Create(*ctx.mGlobalContext, "if.else", ctx.mFunc);
+        chain.push_back({stmt, thenBody, end});
 
-        builder.CreateCondBr(value, thenBody, elseBody);
+        ASTIfStmt * elseIf = nullptr;
 
-        ctx.mBlock = elseBody;
+        if (stmt->mElseStmt) {
+            elseBody = llvm::BasicBlock::Create(*ctx.mGlobalContext, "if.else", ctx.mFunc);
 
-        mElseStmt->codegen(ctx);
-        
-        llvm::IRBuilder<> builderElse(ctx.mBlock);
+            builder.CreateCondBr(value, thenBody, elseBody);
+
+            ctx.mBlock = elseBody;
+
+            elseIf = dyn_cast<ASTIfStmt>(stmt->mElseStmt);
 
-        builderElse.CreateBr(end);
-    } else { 
-        builder.CreateCondBr(value, thenBody, end);
+            if (!elseIf) stmt->mElseStmt->codegen(ctx);
+        } else { 
+            builder.CreateCondBr(value, thenBody, end);
+        }
+
+        stmt = elseIf;
     }
-    
-    ctx.mBlock = thenBody;
 
-    mThenStmt->codegen(ctx);
+    while (!chain.empty()) {
+        OpenIf open = chain.back();
+        chain.pop_back();
+
+        if (open.mStmt->mElseStmt) {
+            llvm::IRBuilder<> builderElse(ctx.mBlock);
+
+            builderElse.CreateBr(open.mEnd);
+        }
+        
+        ctx.mBlock = open.mThenBody;
 
-    llvm::IRBuilder<> builderThen(ctx.mBlock);
+        open.mStmt->mThenStmt->codegen(ctx);
 
-    builderThen.CreateBr(end);
+        llvm::IRBuilder<> builderThen(ctx.mBlock);
 
-    ctx.mBlock = end;
+        builderThen.CreateBr(open.mEnd);
+
+        ctx.mBlock = open.mEnd;
+    }
 
 	return nullptr;
 }
@@ -295,8 +349,6 @@ llvm::Value * ASTFuncExpr::codegen(CodeContext& ctx) noexcept {
 
     // create callable entity in LLVM IR
     llvm::FunctionCallee funcCallee(func);
-    
-    std::shared_ptr<ASTFunc> ref = this->mIdent.getFunction();
 
     if (this->mType != Type::Void) {
 		retVal = build.CreateCall(funcCallee, callList);
@@ -307,136 +359,227 @@ llvm::Value * ASTFuncExpr::codegen(CodeContext& ctx) noexcept {
 	return retVal;
 }
 
-llvm::Value * ASTLogicalAnd::codegen(CodeContext& ctx) noexcept {	
-	// create the block for the RHS
-	llvm::BasicBlock * rhsBlock = llvm::BasicBlock::Create(*ctx.mGlobalContext, "and.rhs", ctx.mFunc);
-	
-	// in both "true" and "false" condition we will jump to and.end
-	// this is because we will insert a phi node that assumes false
-	// if the and.end jump was from the lhs block
-	llvm::BasicBlock * endBlock = llvm::BasicBlock::Create(*ctx.mGlobalContext, "and.end", ctx.mFunc);
-	
-	// now generate the LHS
-	llvm::Value * lhsVal = mLHS->codegen(ctx);
+/*
+a chain of binary exprs down the left side e.g. a + b + c + ... from a code generator is as deep as it is long, so the
+chain is emitted in a loop instead of by recursing into each lhs. every op is split at its lhs, openOp does what the op
+does before its lhs is emitted and closeOp the rest, which keeps the IR in the same order as a recursive walk
+*/
 
-	llvm::BasicBlock * lhsBlock = ctx.mBlock;
-	
-	// add the branch to the end of the LHS
-	{
-		llvm::IRBuilder<> build(ctx.mBlock);
+namespace {
+	// what an op keeps between its two halves
+	struct OpenOp {
+		ASTBinaryExpr * mExpr;
 
-		// we can assume it will be an i32 here
-		// since it would have been zero-extended otherwise
-		lhsVal = build.CreateICmpNE(lhsVal, llvm::Constant::getNullValue(llvm::IntegerType::getInt32Ty(*ctx.mGlobalContext)), "tobool");
-		build.CreateCondBr(lhsVal, rhsBlock, endBlock);
-	}
-	
-	// code should now be generated in the RHS block
-	ctx.mBlock = rhsBlock;
+		// block a math or cmp op is emitted in
+		llvm::BasicBlock * mBlock;
 
-	llvm::Value * rhsVal = mRHS->codegen(ctx);
-	
-	// this is the final RHS block (for the phi node)
-	rhsBlock = ctx.mBlock;
-	
-	// add the branch and the end of the RHS
-	{
-		llvm::IRBuilder<> build(ctx.mBlock);
-		rhsVal = build.CreateICmpNE(rhsVal, llvm::Constant::getNullValue(llvm::IntegerType::getInt32Ty(*ctx.mGlobalContext)), "tobool");
-		
-		// we do an unconditional branch because the phi mode will handle
-		// the correct value
-		build.CreateBr(endBlock);
+		// math ops emit their rhs before their lhs
+		llvm::Value * mRHS;
+
+		// && and || branch around their rhs
+		llvm::BasicBlock * mRHSBlock;
+		llvm::BasicBlock * mEndBlock;
+	};
+
+	// an assignment needs an ident on its left so it is never part of a chain
+	bool isChainOp(const ASTExpr * expr) noexcept {
+		return isa<ASTBinaryExpr>(expr) && !isa<ASTAssignOp>(expr);
 	}
-	
-	ctx.mBlock = endBlock;
-	
-	llvm::IRBuilder<> build(ctx.mBlock);
-	
-	// figure out the value to zext
-	llvm::Value * zextVal = nullptr;
-	
-	// if rhs is true we need to make a phi
-	if (rhsVal != llvm::ConstantInt::getFalse(*ctx.mGlobalContext)) {
-		llvm::PHINode * phi = build.CreatePHI(llvm::Type::getInt1Ty(*ctx.mGlobalContext), 2);
-		
-        // if we came from the lhs it had to be false
-		phi->addIncoming(llvm::ConstantInt::getFalse(*ctx.mGlobalContext), lhsBlock);
-		
-        phi->addIncoming(rhsVal, rhsBlock);
 
-		zextVal = phi;
-	} else {
-		zextVal = llvm::ConstantInt::getFalse(*ctx.mGlobalContext);
+	void openOp(OpenOp& op, CodeContext& ctx) noexcept {
+		switch (op.mExpr->getKind()) {
+			case NodeKind::LogicalAnd:
+				// create the block for the RHS
+				op.mRHSBlock = llvm::BasicBlock::Create(*ctx.mGlobalContext, "and.rhs", ctx.mFunc);
+
+				// in both "true" and "false" condition we will jump to and.end
+				// this is because we will insert a phi node that assumes false
+				// if the and.end jump was from the lhs block
+				op.mEndBlock = llvm::BasicBlock::Create(*ctx.mGlobalContext, "and.end", ctx.mFunc);
+				break;
+			case NodeKind::LogicalOr:
+				// same as && but the phi assumes true
+				op.mRHSBlock = llvm::BasicBlock::Create(*ctx.mGlobalContext, "or.rhs", ctx.mFunc);
+				op.mEndBlock = llvm::BasicBlock::Create(*ctx.mGlobalContext, "or.end", ctx.mFunc);
+				break;
+			case NodeKind::BinaryMathOp:
+				op.mBlock = ctx.mBlock;
+				op.mRHS = op.mExpr->getRHS()->codegen(ctx);
+				break;
+			default:
+				op.mBlock = ctx.mBlock;
+				break;
+		}
 	}
-	
-	return build.CreateZExt(zextVal, llvm::Type::getInt32Ty(*ctx.mGlobalContext));
-}
 
-llvm::Value * ASTLogicalOr::codegen(CodeContext& ctx) noexcept {
-	// create the block for the RHS
-	llvm::BasicBlock * rhsBlock = llvm::BasicBlock::Create(*ctx.mGlobalContext, "or.rhs", ctx.mFunc);
-	
-	// in both "true" and "false" condition we will jump to and.end
-	// this is because we will insert a phi node that assumes false
-	// if the and.end jump was from the lhs block
-	llvm::BasicBlock * endBlock = llvm::BasicBlock::Create(*ctx.mGlobalContext, "or.end", ctx.mFunc);
-	
-	// now generate the LHS
-	llvm::Value * lhsVal = mLHS->codegen(ctx);
+	// && and || once the lhs is emitted, the phi takes value if the jump to end came straight from the lhs
+	llvm::Value * closeShortCircuit(OpenOp& op, llvm::Value * lhsVal, llvm::ConstantInt * value, CodeContext& ctx) noexcept {
+		llvm::BasicBlock * lhsBlock = ctx.mBlock;
+		llvm::BasicBlock * rhsBlock = op.mRHSBlock;
+		llvm::BasicBlock * endBlock = op.mEndBlock;
 
-	llvm::BasicBlock * lhsBlock = ctx.mBlock;
-	
-	// add the branch to the end of the LHS
-	{
-		llvm::IRBuilder<> build(ctx.mBlock);
+		// add the branch to the end of the LHS
+		{
+			llvm::IRBuilder<> build(ctx.mBlock);
 
-		// we can assume it will be an i32 here
-		// since it would have been zero-extended otherwise
-		lhsVal = build.CreateICmpNE(lhsVal, llvm::Constant::getNullValue(llvm::IntegerType::getInt32Ty(*ctx.mGlobalContext)), "tobool");
-		build.CreateCondBr(lhsVal, rhsBlock, endBlock);
-	}
-	
-	// code should now be generated in the RHS block
-	ctx.mBlock = rhsBlock;
+			// we can assume it will be an i32 here
+			// since it would have been zero-extended otherwise
+			lhsVal = build.CreateICmpNE(lhsVal, llvm::Constant::getNullValue(llvm::IntegerType::getInt32Ty(*ctx.mGlobalContext)), "tobool");
 
-	llvm::Value * rhsVal = mRHS->codegen(ctx);
-	
-	// this is the final RHS block (for the phi node)
-	rhsBlock = ctx.mBlock;
-	
-	// add the branch and the end of the RHS
-	{
+			build.CreateCondBr(lhsVal, rhsBlock, endBlock);
+		}
+		
+		// code should now be generated in the RHS block
+		ctx.mBlock = rhsBlock;
+
+		llvm::Value * rhsVal = op.mExpr->getRHS()->codegen(ctx);
+		
+		// this is the final RHS block (for the phi node)
+		rhsBlock = ctx.mBlock;
+		
+		// add the branch and the end of the RHS
+		{
+			llvm::IRBuilder<> build(ctx.mBlock);
+			rhsVal = build.CreateICmpNE(rhsVal, llvm::Constant::getNullValue(llvm::IntegerType::getInt32Ty(*ctx.mGlobalContext)), "tobool");
+			
+			// we do an unconditional branch because the phi mode will handle
+			// the correct value
+			build.CreateBr(endBlock);
+		}
+		
+		ctx.mBlock = endBlock;
+		
 		llvm::IRBuilder<> build(ctx.mBlock);
-		rhsVal = build.CreateICmpNE(rhsVal, llvm::Constant::getNullValue(llvm::IntegerType::getInt32Ty(*ctx.mGlobalContext)), "tobool");
 		
-		// we do an unconditional branch because the phi mode will handle
-		// the correct value
-		build.CreateBr(endBlock);
-	}
-	
-	ctx.mBlock = endBlock;
-	
-	llvm::IRBuilder<> build(ctx.mBlock);
-	
-	// figure out the value to zext
-	llvm::Value * zextVal = nullptr;
-	
-	// if rhs is false we need to make a phi
-	if (rhsVal != llvm::ConstantInt::getTrue(*ctx.mGlobalContext)) {
-		llvm::PHINode * phi = build.CreatePHI(llvm::Type::getInt1Ty(*ctx.mGlobalContext), 2);
+		// figure out the value to zext
+		llvm::Value * zextVal = nullptr;
 		
-        // if we came from the lhs it had to be true
-		phi->addIncoming(llvm::ConstantInt::getTrue(*ctx.mGlobalContext), lhsBlock);
+		// if rhs can be anything but value we need to make a phi
+		if (rhsVal != value) {
+			llvm::PHINode * phi = build.CreatePHI(llvm::Type::getInt1Ty(*ctx.mGlobalContext), 2);
+			
+			// if we came from the lhs it had to be value
+			phi->addIncoming(value, lhsBlock);
+			
+			phi->addIncoming(rhsVal, rhsBlock);
+
+			zextVal = phi;
+		} else {
+			zextVal = value;
+		}
 		
-        phi->addIncoming(rhsVal, rhsBlock);
+		return build.CreateZExt(zextVal, llvm::Type::getInt32Ty(*ctx.mGlobalContext));
+	}
 
-		zextVal = phi;
-	} else {
-		zextVal = llvm::ConstantInt::getTrue(*ctx.mGlobalContext);
+	llvm::Value * closeOp(OpenOp& op, llvm::Value * lhs, CodeContext& ctx) noexcept {
+		llvm::Value * retVal = nullptr;
+
+		switch (op.mExpr->getKind()) {
+			case NodeKind::LogicalAnd:
+				return closeShortCircuit(op, lhs, llvm::ConstantInt::getFalse(*ctx.mGlobalContext), ctx);
+			case NodeKind::LogicalOr:
+				return closeShortCircuit(op, lhs, llvm::ConstantInt::getTrue(*ctx.mGlobalContext), ctx);
+			case NodeKind::BinaryCmpOp: {
+				llvm::IRBuilder<> builder(op.mBlock);
+
+				llvm::Value * rhs = op.mExpr->getRHS()->codegen(ctx);
+
+				switch (op.mExpr->getOp()) {
+					case TokenType::EqualTo:
+						retVal = builder.CreateICmpEQ(lhs, rhs);
+
+						break;
+					case TokenType::NotEqual:
+						retVal = builder.CreateICmpNE(lhs, rhs);
+
+						break;
+					case TokenType::GreaterThan:
+						retVal = builder.CreateICmpSGT(lhs, rhs);
+						break;
+					case TokenType::LessThan:
+						retVal = builder.CreateICmpSLT(lhs, rhs);
+
+						break;
+					case TokenType::GThanOrEq:
+						retVal = builder.CreateICmpSGE(lhs, rhs);
+
+						break;
+					case TokenType::LThanOrEq:
+						retVal = builder.CreateICmpSLE(lhs, rhs);
+
+						break;
+					default:
+						break;
+				}
+
+				break;
+			}
+			default: {
+				llvm::IRBuilder<> builder(op.mBlock);
+
+				llvm::Value * rhs = op.mRHS;
+
+				switch (op.mExpr->getOp()) {
+					case TokenType::Plus:
+						retVal = builder.CreateAdd(lhs, rhs);
+
+						break;
+					case TokenType::Minus:
+						retVal = builder.CreateSub(lhs, rhs);
+
+						break;
+					case TokenType::Mult:
+						retVal = builder.CreateMul(lhs, rhs);
+
+						break;
+					case TokenType::Div:
+						retVal = builder.CreateSDiv(lhs, rhs);
+
+						break;
+					case TokenType::Mod:
+						retVal = builder.CreateSRem(lhs, rhs);
+
+						break;
+					default:
+						break;
+				}
+
+				break;
+			}
+		}
+
+		return retVal;
+	}
+
+	// opens the ops on the way down the chain, emits whatever ends it and closes them on the way back up
+	llvm::Value * emitChain(ASTBinaryExpr * expr, CodeContext& ctx) noexcept {
+		std::vector<OpenOp> chain;
+		ASTExpr * node = expr;
+
+		while (isChainOp(node)) {
+			chain.push_back({cast<ASTBinaryExpr>(node), nullptr, nullptr, nullptr, nullptr});
+			openOp(chain.back(), ctx);
+
+			node = chain.back().mExpr->getLHS();
+		}
+
+		llvm::Value * value = node->codegen(ctx);
+
+		while (!chain.empty()) {
+			value = closeOp(chain.back(), value, ctx);
+			chain.pop_back();
+		}
+
+		return value;
 	}
-	
-	return build.CreateZExt(zextVal, llvm::Type::getInt32Ty(*ctx.mGlobalContext));
+}
+
+llvm::Value * ASTLogicalAnd::codegen(CodeContext& ctx) noexcept {
+	return emitChain(this, ctx);
+}
+
+llvm::Value * ASTLogicalOr::codegen(CodeContext& ctx) noexcept {
+	return emitChain(this, ctx);
 }
 
 llvm::Value * ASTAssignOp::codegen(CodeContext& ctx) noexcept {
@@ -447,8 +590,8 @@ llvm::Value * ASTAssignOp::codegen(CodeContext& ctx) noexcept {
     // lhs will be address to ident or GEP for array
     llvm::Value * lhs;
 
-    std::shared_ptr<ASTArrayExpr> arrIdent = std::dynamic_pointer_cast<ASTArrayExpr>(this->mLHS);
-    std::shared_ptr<ASTIdentExpr> ident = std::dynamic_pointer_cast<ASTIdentExpr>(this->mLHS);
+    ASTArrayExpr * arrIdent = dyn_cast<ASTArrayExpr>(this->mLHS);
+    ASTIdentExpr * ident = dyn_cast<ASTIdentExpr>(this->mLHS);
 
     // either lhs is ident or array index into array ident
     if (ident) {
@@ -521,78 +664,11 @@ llvm::Value * ASTAssignOp::codegen(CodeContext& ctx) noexcept {
 }
 
 llvm::Value * ASTBinaryCmpOp::codegen(CodeContext& ctx) noexcept {
-    llvm::Value * retVal = nullptr;
-	
-    llvm::IRBuilder<> builder(ctx.mBlock);
-    
-    llvm::Value * lhs = this->mLHS->codegen(ctx);
-    llvm::Value * rhs = this->mRHS->codegen(ctx);
-
-    switch (this->mOp) {
-        case TokenType::EqualTo:
-            retVal = builder.CreateICmpEQ(lhs, rhs);
-
-            break;
-        case TokenType::NotEqual:
-            retVal = builder.CreateICmpNE(lhs, rhs);
-
-            break;
-        case TokenType::GreaterThan:
-            retVal = builder.CreateICmpSGT(lhs, rhs);
-            break;
-        case TokenType::LessThan:
-            retVal = builder.CreateICmpSLT(lhs, rhs);
-
-            break;
-        case TokenType::GThanOrEq:
-            retVal = builder.CreateICmpSGE(lhs, rhs);
-
-            break;
-        case TokenType::LThanOrEq:
-            retVal = builder.CreateICmpSLE(lhs, rhs);
-
-            break;
-        default:
-            break;
-    }
-	
-	return retVal;
+    return emitChain(this, ctx);
 }
 
 llvm::Value * ASTBinaryMathOp::codegen(CodeContext& ctx) noexcept {
-    llvm::Value * retVal = nullptr;
-	
-    llvm::IRBuilder<> builder(ctx.mBlock);
-    
-    llvm::Value * rhs = this->mRHS->codegen(ctx);
-    llvm::Value * lhs = this->mLHS->codegen(ctx);
-    
-    switch (this->mOp) {
-        case TokenType::Plus:
-            retVal = builder.CreateAdd(lhs, rhs);
-
-            break;
-        case TokenType::Minus:
-            retVal = builder.CreateSub(lhs, rhs);
-
-            break;
-        case TokenType::Mult:
-            retVal = builder.CreateMul(lhs, rhs);
-
-            break;
-        case TokenType::Div:
-            retVal = builder.CreateSDiv(lhs, rhs);
-
-            break;
-        case TokenType::Mod:
-            retVal = builder.CreateSRem(lhs, rhs);
-
-            break;
-        default:
-            break;
-    }
-	
-	return retVal;
+    return emitChain(this, ctx);
 }
 
 llvm::Value * ASTNotExpr::codegen(CodeContext& ctx) noexcept {
@@ -618,11 +694,16 @@ llvm::Value * ASTIncExpr::codegen(CodeContext& ctx) noexcept {
     // create updated value
     llvm::Value * newVal = builder.CreateAdd(load, llvm::ConstantInt::get(llvm::Type::getInt32Ty(*ctx.mGlobalContext), 1));
     
-    llvm::Value * dest;
-    if (auto arrIdent = std::dynamic_pointer_cast<ASTArrayExpr>(this->mExpr)) {
-        dest = arrIdent->getIndexLoc();
-    } else if (auto ident = std::dynamic_pointer_cast<ASTIdentExpr>(this->mExpr)) {
-        dest = ident->getAddress();
+    llvm::Value * dest = nullptr;
+    switch (this->mExpr->getKind()) {
+        case NodeKind::ArrayExpr:
+            dest = cast<ASTArrayExpr>(this->mExpr)->getIndexLoc();
+            break;
+        case NodeKind::IdentExpr:
+            dest = cast<ASTIdentExpr>(this->mExpr)->getAddress();
+            break;
+        default:
+            break;
     }
 
     // load updated value back into ident
@@ -640,11 +721,16 @@ llvm::Value * ASTDecExpr::codegen(CodeContext& ctx) noexcept {
     // create updated value
     llvm::Value * newVal = builder.CreateSub(load, llvm::ConstantInt::get(llvm::Type::getInt32Ty(*ctx.mGlobalContext), 1));
     
-    llvm::Value * dest;
-    if (auto arrIdent = std::dynamic_pointer_cast<ASTArrayExpr>(this->mExpr)) {
-        dest = arrIdent->getIndexLoc();
-    } else if (auto ident = std::dynamic_pointer_cast<ASTIdentExpr>(this->mExpr)) {
-        dest = ident->getAddress();
+    llvm::Value * dest = nullptr;
+    switch (this->mExpr->getKind()) {
+        case NodeKind::ArrayExpr:
+            dest = cast<ASTArrayExpr>(this->mExpr)->getIndexLoc();
+            break;
+        case NodeKind::IdentExpr:
+            dest = cast<ASTIdentExpr>(this->mExpr)->getAddress();
+            break;
+        default:
+            break;
     }
 
     // load updated value back into ident
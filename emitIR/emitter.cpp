@@ -19,13 +19,14 @@ CodeContext::CodeContext(StringTable& strings, const char * file) noexcept
 , mPrintfIdent {nullptr} { }
 
 Emitter::Emitter(Parser& parser) noexcept
-: mCodeContext {parser.mStringTable, parser.mFileName} {
-	if (parser.mNeedPrintf) {
-		mCodeContext.mPrintfIdent = parser.mSymbolTable.getIdentifier("printf");
-	}
+: Emitter {parser.mRoot, parser.mStringTable, parser.mNeedPrintf ? parser.mSymbolTable.getIdentifier(Atoms::Printf) : nullptr, parser.mFileName} { }
+
+Emitter::Emitter(ASTProg * root, StringTable& strings, Identifier * printfIdent, const char * fileName) noexcept
+: mCodeContext {strings, fileName} {
+	mCodeContext.mPrintfIdent = printfIdent;
 		
 	// this is what kicks off the generation of the LLVM IR from the AST
-	parser.mRoot->codegen(mCodeContext);
+	root->codegen(mCodeContext);
 }
 
 void Emitter::print() noexcept {
@@ -23,6 +23,9 @@ defines the LLVM IR Emitter class which is used for codegen aswell as a helper s
 // in ../parse/symbols.h
 class StringTable; class Identifier;
 
+// in ../parse/astNodes.h
+class ASTProg;
+
 // in ../parse/parser.h
 class Parser;
 
@@ -53,6 +56,10 @@ struct CodeContext {
 class Emitter {
 public:
 	Emitter(Parser& parser) noexcept;
+
+    // same for an AST that did not come straight from a parser (e.g. one loaded from ../parse/astCache.h)
+    // printfIdent is the identifier its printf calls refer to or nullptr if it needs no printf declared
+    Emitter(ASTProg * root, StringTable& strings, Identifier * printfIdent, const char * fileName) noexcept;
     ~Emitter() noexcept = default;
 
     // print bitcode to stdout
@@ -0,0 +1,59 @@
+#include <cstring>
+#include "../scan/lineTable.h"
+#include "../scan/source.h"
+#include "diagnostics.h"
+
+void Diagnostics::render(std::ostream& output, const std::vector<Diagnostic>& errors, unsigned limit) const {
+    std::string out;
+
+    for (const Diagnostic& error : errors) {
+        std::string_view line = lineText(error.mLine);
+
+        out += mFileName;
+        out += ':';
+        out += std::to_string(error.mLine);
+        out += ':';
+        out += std::to_string(error.mCol);
+        out += ": error: ";
+        out += error.mMsg;
+        out += '\n';
+
+        out += line;
+        out += '\n';
+
+        // tabs are kept so the caret lines up however wide they are shown, the column can be past the end of the
+        // line (e.g. an error at the newline) so only the chars the line has are looked at
+        for (std::int64_t i = 0; i < error.mCol - 1; ++i) {
+            out += static_cast<std::size_t>(i) < line.size() && line[i] == '\t' ? '\t' : ' ';
+        }
+
+        out += "^\n";
+    }
+
+    if (limit) {
+        out += "crisp: error: too many errors, stopping now [-ferror-limit=";
+        out += std::to_string(limit);
+        out += "]\n";
+    }
+
+    output.write(out.data(), out.size());
+    output.flush();
+}
+
+std::string_view Diagnostics::lineText(std::int64_t line) const noexcept {
+    if (line < 1 || static_cast<std::size_t>(line) > mLines.size()) return {};
+
+    std::size_t start = mLines.start(line);
+    std::size_t end;
+
+    // a streamed scan only knows the lines up to where it stopped so the last one is found by its newline
+    if (static_cast<std::size_t>(line) < mLines.size()) {
+        end = mLines.start(line + 1) - 1;
+    } else {
+        const void * newline = start < mSource.length() ? std::memchr(mSource.data() + start, '\n', mSource.length() - start) : nullptr;
+
+        end = newline ? static_cast<const char *>(newline) - mSource.data() : mSource.length();
+    }
+
+    return mSource.substr(start, end - start);
+}
@@ -0,0 +1,58 @@
+/*
+
+defines the error reports of a compile and how they are shown i.e. struct Diagnostic and class Diagnostics
+
+the parser only records the message and where it is (see Parser::reportError), the text is rendered once the parse
+is over straight from the bytes the scanner already holds, each line is found through the scanners line starts
+(see ../scan/lineTable.h) so the file is never read again. every error goes into one buffer that is written out w
+a single call instead of flushing the stream after each line
+
+*/
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class SourceBuffer; class LineTable;
+
+// an error at a 1 based line and column
+struct Diagnostic {
+	Diagnostic(std::string msg, std::int64_t line, std::int64_t col)
+	: mMsg(std::move(msg))
+	, mLine(line)
+	, mCol(col) { }
+
+	std::string mMsg;
+	std::int64_t mLine;
+	std::int64_t mCol;
+};
+
+class Diagnostics {
+public:
+	Diagnostics(const char * fileName, const SourceBuffer& source, const LineTable& lines) noexcept
+	: mFileName {fileName}
+	, mSource {source}
+	, mLines {lines} { }
+
+	~Diagnostics() noexcept = default;
+
+	// writes each error as file:line:col: error: msg, the line it is on and a caret under the column
+	// limit != 0 means the parse stopped after limit errors so a note that the rest were not looked at goes last
+	void render(std::ostream& output, const std::vector<Diagnostic>& errors, unsigned limit = 0) const;
+private:
+	// text of line (1 based) w/o its newline, empty past the end of the source
+	std::string_view lineText(std::int64_t line) const noexcept;
+
+	const char * mFileName;
+	const SourceBuffer& mSource;
+	const LineTable& mLines;
+};
+
+#endif
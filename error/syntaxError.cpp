@@ -0,0 +1,40 @@
+#include "syntaxError.h"
+
+std::string SyntaxError::mismatch(TokenType expected, TokenType actual, std::string_view str) {
+    std::string msg = "Expected: ";
+    msg += Token::mToString[expected];
+    msg += " but saw: ";
+
+    if (actual != TokenType::Identifier && actual != TokenType::StringLit &&
+        actual != TokenType::CharLit && actual != TokenType::IntLit &&
+        actual != TokenType::DoubleLit) {
+
+        msg += Token::mToString[actual];
+    } else {
+        msg += str;
+    }
+
+    return msg;
+}
+
+std::string SyntaxError::unknownToken(std::string_view str) {
+	std::string msg = "Invalid symbol: ";
+	msg += str;
+
+	return msg;
+}
+
+std::string SyntaxError::operandMissing(TokenType op) {
+	std::string msg = "Binary operation ";
+	msg += Token::mToString[op];
+	msg += " requires two operands.";
+
+	return msg;
+}
+
+std::string SyntaxError::tooDeep(unsigned limit) {
+	std::string msg = "Nesting exceeds the maximum depth of ";
+	msg += std::to_string(limit);
+
+	return msg;
+}
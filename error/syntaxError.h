@@ -0,0 +1,35 @@
+/*
+
+defines the messages for syntax errors found during parse i.e. class SyntaxError
+
+syntax errors are not thrown, the parser reports them through its error vector, stops consuming tokens and unwinds
+to the nearest recovery point where it resyncs on a FOLLOW set (see ../parse/tokenSet.h). this just builds the
+message text so every parse function words the same error the same way
+
+*/
+
+#ifndef SYNTAX_ERROR_H
+#define SYNTAX_ERROR_H
+
+#include <string>
+#include <string_view>
+#include "../scan/token.h"
+
+class SyntaxError {
+public:
+	static constexpr const char * EndOfFile = "Unexpected end of file";
+
+	// expected one token but saw another (str is the text of the one seen)
+	static std::string mismatch(TokenType expected, TokenType actual, std::string_view str);
+
+	// the scanner could not make a token out of str
+	static std::string unknownToken(std::string_view str);
+
+	// binary operator op has no rhs
+	static std::string operandMissing(TokenType op);
+
+	// statements/expressions nested more than limit levels deep
+	static std::string tooDeep(unsigned limit);
+};
+
+#endif
@@ -0,0 +1,149 @@
+/*
+defines the bump allocator the AST lives in i.e. class Arena and the child lists used by the nodes i.e. ArenaVector
+
+nodes are carved one after another out of large blocks and are never freed one at a time, the whole tree goes away
+at once when the arena (owned by the Parser) is destroyed. destructors are never run, so anything placed in the
+arena must not own memory outside of it (which is why nodes keep their children in an ArenaVector)
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class Arena {
+public:
+	Arena() noexcept
+	: mBlock {nullptr}
+	, mUsed {0}
+	, mCapacity {0}
+	, mBytes {0} { }
+
+	~Arena() noexcept = default;
+
+	// nodes point into the blocks so the arena cant be copied
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	// construct a T in the arena
+	template <typename T, typename... Args>
+	T * make(Args&&... args) noexcept {
+		static_assert(alignof(T) <= alignof(std::max_align_t), "over aligned types are not supported");
+
+		return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	// size bytes aligned to align (a power of 2)
+	void * allocate(std::size_t size, std::size_t align) noexcept {
+		std::size_t at = (mUsed + align - 1) & ~(align - 1);
+
+		if (at + size > mCapacity) {
+			grow(size);
+			at = 0;
+		}
+
+		mUsed = at + size;
+		mBytes += size;
+
+		return mBlock + at;
+	}
+
+	// bytes handed out so far
+	std::size_t bytes() const noexcept {
+		return mBytes;
+	}
+
+	// take over the blocks of other so whatever was made in it lives as long as this arena does
+	void adopt(Arena& other) noexcept {
+		for (auto& block : other.mBlocks) mBlocks.emplace_back(std::move(block));
+
+		mBytes += other.mBytes;
+
+		other.mBlocks.clear();
+		other.mBlock = nullptr;
+		other.mUsed = 0;
+		other.mCapacity = 0;
+		other.mBytes = 0;
+	}
+private:
+	// first block size, each new block doubles up to MaxBlock
+	static constexpr std::size_t MinBlock = 1 << 16;
+	static constexpr std::size_t MaxBlock = 1 << 22;
+
+	std::vector<std::unique_ptr<char[]>> mBlocks;
+
+	// block being bumped through
+	char * mBlock;
+	std::size_t mUsed;
+	std::size_t mCapacity;
+
+	std::size_t mBytes;
+
+	// start a new block that fits at least size bytes
+	void grow(std::size_t size) noexcept {
+		std::size_t capacity = mCapacity ? std::min(mCapacity * 2, MaxBlock) : MinBlock;
+
+		if (capacity < size) capacity = size;
+
+		mBlocks.emplace_back(new char[capacity]);
+		mBlock = mBlocks.back().get();
+		mUsed = 0;
+		mCapacity = capacity;
+	}
+};
+
+// growable array of node pointers stored in an arena, outgrown storage is just left behind in the arena
+template <typename T>
+class ArenaVector {
+public:
+	static_assert(std::is_trivially_copyable<T>::value, "ArenaVector elements are moved w memcpy");
+
+	ArenaVector() noexcept
+	: mData {nullptr}
+	, mSize {0}
+	, mCapacity {0} { }
+
+	void push_back(Arena& arena, T value) noexcept {
+		if (mSize == mCapacity) {
+			std::uint32_t capacity = mCapacity ? mCapacity * 2 : 4;
+			T * data = static_cast<T *>(arena.allocate(capacity * sizeof(T), alignof(T)));
+
+			if (mSize) std::memcpy(data, mData, mSize * sizeof(T));
+
+			mData = data;
+			mCapacity = capacity;
+		}
+
+		mData[mSize++] = value;
+	}
+
+	std::size_t size() const noexcept {
+		return mSize;
+	}
+
+	T operator[](std::size_t i) const noexcept {
+		return mData[i];
+	}
+
+	const T * begin() const noexcept {
+		return mData;
+	}
+
+	const T * end() const noexcept {
+		return mData + mSize;
+	}
+private:
+	T * mData;
+	std::uint32_t mSize;
+	std::uint32_t mCapacity;
+};
+
+#endif
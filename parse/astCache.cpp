@@ -0,0 +1,670 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <unistd.h>
+#include "astCache.h"
+#include "parse.h"
+
+namespace {
+	constexpr char Magic[4] = {'C', 'A', 'S', 'T'};
+
+	// where each section starts, mEnd is the size of the file
+	struct Layout {
+		std::size_t mNodes;
+		std::size_t mKids;
+		std::size_t mIdents;
+		std::size_t mStrings;
+		std::size_t mText;
+		std::size_t mEnd;
+	};
+
+	Layout layout(const ASTCache::Header& header) noexcept {
+		Layout at;
+
+		at.mNodes = sizeof(ASTCache::Header);
+		at.mKids = at.mNodes + std::size_t {header.mNodes} * sizeof(ASTCache::Node);
+
+		// the kids are the only section that can end off an 8 byte boundary
+		at.mIdents = (at.mKids + std::size_t {header.mKids} * sizeof(std::uint32_t) + 7) & ~std::size_t {7};
+		at.mStrings = at.mIdents + std::size_t {header.mIdents} * sizeof(ASTCache::Ident);
+		at.mText = at.mStrings + std::size_t {header.mStrings} * sizeof(ASTCache::Str);
+		at.mEnd = at.mText + header.mText;
+
+		return at;
+	}
+
+	// FNV-1a a word at a time, folded after each step so the high bytes of a word reach the low bits of the hash
+	struct Hash {
+		std::uint64_t mValue = 14695981039346656037ull;
+
+		void add(std::uint64_t word) noexcept {
+			mValue = (mValue ^ word) * 1099511628211ull;
+			mValue ^= mValue >> 32;
+		}
+
+		// length goes in last so "ab" + "c" and "a" + "bc" differ
+		void add(const char * data, std::size_t length) noexcept {
+			std::size_t i = 0;
+
+			for (; i + 8 <= length; i += 8) {
+				std::uint64_t word;
+				std::memcpy(&word, data + i, 8);
+				add(word);
+			}
+
+			std::uint64_t tail = 0;
+			std::memcpy(&tail, data + i, length - i);
+			add(tail);
+
+			add(length);
+		}
+	};
+}
+
+std::uint64_t ASTCache::key(const SourceBuffer& source, unsigned maxDepth, const std::vector<std::string>& roots) noexcept {
+	Hash hash;
+
+	hash.add(Version);
+
+	// a source can be fine w one nesting budget and too deep for another
+	hash.add(maxDepth);
+
+	// reachability mode keeps only the functions the roots get to
+	for (const std::string& root : roots) hash.add(root.data(), root.size());
+
+	hash.add(roots.size());
+	hash.add(source.data(), source.length());
+
+	return hash.mValue;
+}
+
+std::string ASTCache::path(const std::string& dir, std::uint64_t key) {
+	char name[32];
+	std::snprintf(name, sizeof(name), "/%016llx.ast", static_cast<unsigned long long>(key));
+
+	return dir + name;
+}
+
+void ASTCache::children(const ASTNode * node, std::vector<const ASTNode *>& out) noexcept {
+	switch (node->getKind()) {
+		case NodeKind::Prog:
+			for (const ASTFunc * func : static_cast<const ASTProg *>(node)->mFuncs) out.push_back(func);
+			break;
+		case NodeKind::Func: {
+			const ASTFunc * func = static_cast<const ASTFunc *>(node);
+
+			for (const ASTArgDecl * arg : func->mArgs) out.push_back(arg);
+
+			out.push_back(func->mBody);
+			break;
+		}
+		case NodeKind::Decl:
+			out.push_back(static_cast<const ASTDecl *>(node)->mExpr);
+			break;
+		case NodeKind::CompoundStmt:
+			for (const ASTStmt * stmt : static_cast<const ASTCompoundStmt *>(node)->mStmts) out.push_back(stmt);
+			break;
+		case NodeKind::IfStmt: {
+			const ASTIfStmt * stmt = static_cast<const ASTIfStmt *>(node);
+
+			out.insert(out.end(), {stmt->mExpr, stmt->mThenStmt, stmt->mElseStmt});
+			break;
+		}
+		case NodeKind::ReturnStmt:
+			out.push_back(static_cast<const ASTReturnStmt *>(node)->mExpr);
+			break;
+		case NodeKind::WhileStmt:
+			out.insert(out.end(), {static_cast<const ASTWhileStmt *>(node)->mExpr, static_cast<const ASTWhileStmt *>(node)->mLoopStmt});
+			break;
+		case NodeKind::ExprStmt:
+			out.push_back(static_cast<const ASTExprStmt *>(node)->mExpr);
+			break;
+		case NodeKind::ArrayExpr:
+			out.push_back(static_cast<const ASTArrayExpr *>(node)->mExpr);
+			break;
+		case NodeKind::FuncExpr:
+			for (const ASTExpr * arg : static_cast<const ASTFuncExpr *>(node)->mArgs) out.push_back(arg);
+			break;
+		case NodeKind::AssignOp:
+		case NodeKind::LogicalAnd:
+		case NodeKind::LogicalOr:
+		case NodeKind::BinaryCmpOp:
+		case NodeKind::BinaryMathOp:
+			out.insert(out.end(), {static_cast<const ASTBinaryExpr *>(node)->getLHS(), static_cast<const ASTBinaryExpr *>(node)->getRHS()});
+			break;
+		case NodeKind::NotExpr:
+			out.push_back(static_cast<const ASTNotExpr *>(node)->mExpr);
+			break;
+		case NodeKind::IncExpr:
+			out.push_back(static_cast<const ASTIncExpr *>(node)->mExpr);
+			break;
+		case NodeKind::DecExpr:
+			out.push_back(static_cast<const ASTDecExpr *>(node)->mExpr);
+			break;
+		case NodeKind::AddrOfArray:
+			out.push_back(static_cast<const ASTAddrOfArray *>(node)->mArray);
+			break;
+		default:
+			break;
+	}
+}
+
+bool ASTCache::write(const std::string& path, std::uint64_t key, Parser& parser) {
+	if (!parser.isValid() || !parser.getRoot()) return false;
+
+	std::vector<Node> nodes;
+	std::vector<std::uint32_t> kids;
+	std::vector<Ident> idents;
+	std::vector<Str> strings;
+	std::string text;
+
+	std::unordered_map<const Identifier *, std::uint32_t> identAt;
+	std::unordered_map<const ConstStr *, std::uint32_t> stringAt;
+
+	auto identOf = [&](const Identifier& ident) {
+		auto found = identAt.emplace(&ident, idents.size());
+
+		if (found.second) {
+			Ident record {};
+			record.mName = text.size();
+			record.mLength = ident.getName().size();
+			record.mType = ident.getType();
+			record.mElemCount = ident.getArrayCount();
+
+			idents.push_back(record);
+			text += ident.getName();
+		}
+
+		return found.first->second;
+	};
+
+	// the whole table in first use order, strings only a dropped function used are still emitted by codegen
+	for (const ConstStr * str : parser.mStringTable.getOrdered()) {
+		stringAt.emplace(str, strings.size());
+		strings.push_back(Str {static_cast<std::uint32_t>(text.size()), static_cast<std::uint32_t>(str->getText().size())});
+		text += str->getText();
+	}
+
+	// post order w the nodes whose children are still being written on a stack, blocks and else if chains nest as
+	// deep as the source does so this cant recurse
+	struct Frame {
+		const ASTNode * mNode;
+		std::vector<const ASTNode *> mChildren;
+
+		// record of each child written so far
+		std::vector<std::uint32_t> mIndices;
+	};
+
+	std::vector<Frame> open;
+	open.push_back(Frame {parser.getRoot(), {}, {}});
+	children(parser.getRoot(), open.back().mChildren);
+
+	for (;;) {
+		Frame& top = open.back();
+
+		if (top.mIndices.size() < top.mChildren.size()) {
+			const ASTNode * child = top.mChildren[top.mIndices.size()];
+
+			if (!child) {
+				top.mIndices.push_back(None);
+			} else {
+				open.push_back(Frame {child, {}, {}});
+				children(child, open.back().mChildren);
+			}
+
+			continue;
+		}
+
+		const ASTNode * node = top.mNode;
+
+		Node record {};
+		record.mKind = node->getKind();
+		record.mRef = None;
+		record.mFirst = kids.size();
+		record.mCount = top.mIndices.size();
+
+		kids.insert(kids.end(), top.mIndices.begin(), top.mIndices.end());
+
+		if (const ASTExpr * expr = dyn_cast<ASTExpr>(node)) record.mType = expr->getType();
+
+		switch (node->getKind()) {
+			case NodeKind::Func:
+				record.mType = static_cast<const ASTFunc *>(node)->mReturnType;
+				record.mRef = identOf(static_cast<const ASTFunc *>(node)->mIdent);
+				break;
+			case NodeKind::ArgDecl:
+				record.mRef = identOf(static_cast<const ASTArgDecl *>(node)->mIdent);
+				break;
+			case NodeKind::Decl:
+				record.mRef = identOf(static_cast<const ASTDecl *>(node)->mIdent);
+				break;
+			case NodeKind::IdentExpr:
+				record.mRef = identOf(static_cast<const ASTIdentExpr *>(node)->mIdent);
+				break;
+			case NodeKind::ArrayExpr:
+				record.mRef = identOf(static_cast<const ASTArrayExpr *>(node)->mIdent);
+				break;
+			case NodeKind::FuncExpr:
+				record.mRef = identOf(static_cast<const ASTFuncExpr *>(node)->mIdent);
+				break;
+			case NodeKind::IncExpr:
+				record.mRef = identOf(static_cast<const ASTIncExpr *>(node)->mIdent);
+				break;
+			case NodeKind::DecExpr:
+				record.mRef = identOf(static_cast<const ASTDecExpr *>(node)->mIdent);
+				break;
+			case NodeKind::AssignOp:
+			case NodeKind::LogicalAnd:
+			case NodeKind::LogicalOr:
+			case NodeKind::BinaryCmpOp:
+			case NodeKind::BinaryMathOp:
+				record.mOp = static_cast<const ASTBinaryExpr *>(node)->getOp();
+				break;
+			case NodeKind::StringExpr:
+				record.mRef = stringAt.at(static_cast<const ASTStringExpr *>(node)->mString);
+				break;
+			case NodeKind::ConstantExpr:
+				record.mInt = static_cast<const ASTConstantExpr *>(node)->getValue();
+				break;
+			case NodeKind::DoubleExpr:
+				record.mDouble = static_cast<const ASTDoubleExpr *>(node)->getValue();
+				break;
+			case NodeKind::CharExpr:
+				record.mInt = static_cast<const ASTCharExpr *>(node)->getValue();
+				break;
+			default:
+				break;
+		}
+
+		nodes.push_back(record);
+		open.pop_back();
+
+		if (open.empty()) break;
+
+		open.back().mIndices.push_back(nodes.size() - 1);
+	}
+
+	Header header {};
+	std::memcpy(header.mMagic, Magic, sizeof(Magic));
+	header.mVersion = Version;
+	header.mKey = key;
+
+	// printf is declared whenever the parse saw a call to it, even in a function that was dropped since
+	header.mPrintf = parser.mNeedPrintf ? identOf(*parser.mSymbolTable.getIdentifier(Atoms::Printf)) : None;
+
+	// every index has to fit in 32 bits w None to spare
+	if (nodes.size() >= None || kids.size() >= None || text.size() >= None) return false;
+
+	header.mNodes = nodes.size();
+	header.mKids = kids.size();
+	header.mIdents = idents.size();
+	header.mStrings = strings.size();
+	header.mText = text.size();
+
+	Layout at = layout(header);
+
+	// the sections go out back to back so they are put together first to be checksummed
+	std::string body;
+	body.reserve(at.mEnd - at.mNodes);
+	body.append(reinterpret_cast<const char *>(nodes.data()), nodes.size() * sizeof(Node));
+	body.append(reinterpret_cast<const char *>(kids.data()), kids.size() * sizeof(std::uint32_t));
+	body.resize(at.mIdents - at.mNodes, '\0');
+	body.append(reinterpret_cast<const char *>(idents.data()), idents.size() * sizeof(Ident));
+	body.append(reinterpret_cast<const char *>(strings.data()), strings.size() * sizeof(Str));
+	body.append(text);
+
+	Hash checksum;
+	checksum.add(reinterpret_cast<const char *>(&header), offsetof(Header, mChecksum));
+	checksum.add(body.data(), body.size());
+	header.mChecksum = checksum.mValue;
+
+	std::string temp = path + ".tmp" + std::to_string(getpid());
+
+	{
+		std::ofstream file {temp, std::ios::binary | std::ios::trunc};
+
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(body.data(), body.size());
+
+		if (!file.flush()) {
+			std::remove(temp.c_str());
+			return false;
+		}
+	}
+
+	if (std::rename(temp.c_str(), path.c_str()) != 0) {
+		std::remove(temp.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+ASTCache::ASTCache(const char * path, std::uint64_t key) noexcept
+: mFile {path}
+, mHeader {nullptr}
+, mNodes {nullptr}
+, mKids {nullptr}
+, mIdents {nullptr}
+, mStrings {nullptr}
+, mText {nullptr}
+, mValid {false}
+, mArena {}
+, mScope {}
+, mIdentifiers {} {
+	if (mFile.length() < sizeof(Header)) return;
+
+	mHeader = reinterpret_cast<const Header *>(mFile.data());
+
+	// a stale or foreign file is simply a miss
+	if (std::memcmp(mHeader->mMagic, Magic, sizeof(Magic)) != 0 || mHeader->mVersion != Version || mHeader->mKey != key) return;
+
+	Layout at = layout(*mHeader);
+
+	if (at.mEnd != mFile.length()) return;
+
+	Hash checksum;
+	checksum.add(mFile.data(), offsetof(Header, mChecksum));
+	checksum.add(mFile.data() + at.mNodes, at.mEnd - at.mNodes);
+
+	if (checksum.mValue != mHeader->mChecksum) return;
+
+	mNodes = reinterpret_cast<const Node *>(mFile.data() + at.mNodes);
+	mKids = reinterpret_cast<const std::uint32_t *>(mFile.data() + at.mKids);
+	mIdents = reinterpret_cast<const Ident *>(mFile.data() + at.mIdents);
+	mStrings = reinterpret_cast<const Str *>(mFile.data() + at.mStrings);
+	mText = mFile.data() + at.mText;
+
+	mValid = check();
+}
+
+// the printer and load() trust the records so a truncated or corrupt file has to be turned away here
+bool ASTCache::check() const noexcept {
+	const Header& header = *mHeader;
+
+	if (header.mNodes == 0 || mNodes[header.mNodes - 1].mKind != NodeKind::Prog) return false;
+	if (header.mPrintf != None && header.mPrintf >= header.mIdents) return false;
+
+	for (std::uint32_t i = 0; i < header.mIdents; ++i) {
+		const Ident& ident = mIdents[i];
+
+		if (std::uint64_t {ident.mName} + ident.mLength > header.mText || ident.mType > Type::Function) return false;
+	}
+
+	for (std::uint32_t i = 0; i < header.mStrings; ++i) {
+		if (std::uint64_t {mStrings[i].mText} + mStrings[i].mLength > header.mText) return false;
+	}
+
+	// each node but the root is the child of exactly one node after it, which makes the records a tree
+	std::vector<bool> owned(header.mNodes, false);
+
+	for (std::uint32_t i = 0; i < header.mNodes; ++i) {
+		const Node& node = mNodes[i];
+		const std::uint32_t * kids = mKids + node.mFirst;
+		std::uint32_t count = node.mCount;
+
+		if (node.mKind > NodeKind::CharExpr || node.mType > Type::Function) return false;
+		if (std::uint64_t {node.mFirst} + count > header.mKids) return false;
+
+		// kid n is of a kind in [first, last] (or missing if optional)
+		auto is = [&](std::uint32_t n, NodeKind first, NodeKind last, bool optional = false) {
+			std::uint32_t kid = kids[n];
+
+			if (kid == None) return optional;
+			if (kid >= i || owned[kid]) return false;
+
+			owned[kid] = true;
+
+			return mNodes[kid].mKind >= first && mNodes[kid].mKind <= last;
+		};
+
+		auto expr = [&is](std::uint32_t n, bool optional = false) {
+			return is(n, NodeKind::IdentExpr, NodeKind::CharExpr, optional);
+		};
+
+		auto stmt = [&is](std::uint32_t n, bool optional = false) {
+			return is(n, NodeKind::Decl, NodeKind::NullStmt, optional);
+		};
+
+		bool ident = node.mRef < header.mIdents;
+		bool fine = true;
+
+		switch (node.mKind) {
+			case NodeKind::Prog:
+				for (std::uint32_t n = 0; fine && n < count; ++n) fine = is(n, NodeKind::Func, NodeKind::Func);
+				break;
+			case NodeKind::Func:
+				fine = ident && count > 0;
+
+				for (std::uint32_t n = 0; fine && n + 1 < count; ++n) fine = is(n, NodeKind::ArgDecl, NodeKind::ArgDecl);
+
+				fine = fine && is(count - 1, NodeKind::CompoundStmt, NodeKind::CompoundStmt);
+				break;
+			case NodeKind::ArgDecl:
+			case NodeKind::IdentExpr:
+				fine = ident && count == 0;
+				break;
+			case NodeKind::Decl:
+				fine = ident && count == 1 && expr(0, true);
+				break;
+			case NodeKind::CompoundStmt:
+				for (std::uint32_t n = 0; fine && n < count; ++n) fine = stmt(n);
+				break;
+			case NodeKind::IfStmt:
+				fine = count == 3 && expr(0) && stmt(1) && stmt(2, true);
+				break;
+			case NodeKind::ReturnStmt:
+				fine = count == 1 && expr(0, true);
+				break;
+			case NodeKind::WhileStmt:
+				fine = count == 2 && expr(0) && stmt(1);
+				break;
+			case NodeKind::ExprStmt:
+			case NodeKind::NotExpr:
+				fine = count == 1 && expr(0);
+				break;
+			case NodeKind::NullStmt:
+			case NodeKind::ConstantExpr:
+			case NodeKind::DoubleExpr:
+			case NodeKind::CharExpr:
+				fine = count == 0;
+				break;
+			case NodeKind::ArrayExpr:
+			case NodeKind::IncExpr:
+			case NodeKind::DecExpr:
+				fine = ident && count == 1 && expr(0);
+				break;
+			case NodeKind::FuncExpr:
+				fine = ident;
+
+				for (std::uint32_t n = 0; fine && n < count; ++n) fine = expr(n);
+				break;
+			case NodeKind::AssignOp:
+			case NodeKind::LogicalAnd:
+			case NodeKind::LogicalOr:
+			case NodeKind::BinaryCmpOp:
+			case NodeKind::BinaryMathOp:
+				fine = node.mOp <= TokenType::EndOfFile && count == 2 && expr(0) && expr(1);
+				break;
+			case NodeKind::AddrOfArray:
+				fine = count == 1 && is(0, NodeKind::ArrayExpr, NodeKind::ArrayExpr);
+				break;
+			case NodeKind::StringExpr:
+				fine = node.mRef < header.mStrings && count == 0;
+				break;
+			default:
+				// ForStmt is never built (see Parser::parseForStmt)
+				fine = false;
+				break;
+		}
+
+		if (!fine) return false;
+	}
+
+	return std::all_of(owned.begin(), owned.end() - 1, [](bool b) { return b; });
+}
+
+ASTProg * ASTCache::load(StringTable& strings) noexcept {
+	if (!mValid || !mIdentifiers.empty()) return nullptr;
+
+	const Header& header = *mHeader;
+
+	for (std::uint32_t i = 0; i < header.mIdents; ++i) {
+		const Ident& record = mIdents[i];
+
+		// the constructor is private so the arena can only hand out the memory
+		void * at = mArena.allocate(sizeof(Identifier), alignof(Identifier));
+		Identifier * ident = new (at) Identifier(Atoms::intern(text(record.mName, record.mLength)));
+		ident->setType(record.mType);
+		ident->setArrayCount(record.mElemCount);
+
+		mIdentifiers.push_back(ident);
+	}
+
+	// stored in first use order so their index stands in for the source offset and codegen emits them the same
+	for (std::uint32_t i = 0; i < header.mStrings; ++i) {
+		strings.getString(text(mStrings[i].mText, mStrings[i].mLength), i);
+	}
+
+	// the children of a node are always built before it so this is a single pass
+	std::vector<ASTNode *> built(header.mNodes, nullptr);
+	std::size_t funcs = 0;
+
+	for (std::uint32_t i = 0; i < header.mNodes; ++i) {
+		const Node& record = mNodes[i];
+		const std::uint32_t * kids = mKids + record.mFirst;
+		std::uint32_t count = record.mCount;
+
+		// a missing child (None) comes back as nullptr so the children are cast w cast_or_null
+		auto kid = [&built, kids](std::uint32_t n) {
+			return kids[n] == None ? nullptr : built[kids[n]];
+		};
+
+		Identifier * ident = record.mRef < mIdentifiers.size() ? mIdentifiers[record.mRef] : nullptr;
+		ASTNode * node = nullptr;
+
+		switch (record.mKind) {
+			case NodeKind::Prog: {
+				ASTProg * prog = mArena.make<ASTProg>();
+
+				for (std::uint32_t n = 0; n < count; ++n) prog->addFunction(mArena, cast_or_null<ASTFunc>(kid(n)));
+
+				node = prog;
+				break;
+			}
+			case NodeKind::Func: {
+				ASTFunc * func = mArena.make<ASTFunc>(*ident, record.mType, mScope, funcs++);
+
+				for (std::uint32_t n = 0; n + 1 < count; ++n) func->addArg(mArena, cast_or_null<ASTArgDecl>(kid(n)));
+
+				func->setBody(cast_or_null<ASTCompoundStmt>(kid(count - 1)));
+				ident->setFunction(func);
+
+				node = func;
+				break;
+			}
+			case NodeKind::ArgDecl:
+				node = mArena.make<ASTArgDecl>(*ident);
+				break;
+			case NodeKind::Decl:
+				node = mArena.make<ASTDecl>(*ident, cast_or_null<ASTExpr>(kid(0)));
+				break;
+			case NodeKind::CompoundStmt: {
+				ASTCompoundStmt * block = mArena.make<ASTCompoundStmt>();
+
+				for (std::uint32_t n = 0; n < count; ++n) block->addStmt(mArena, cast_or_null<ASTStmt>(kid(n)));
+
+				node = block;
+				break;
+			}
+			case NodeKind::IfStmt:
+				node = mArena.make<ASTIfStmt>(cast_or_null<ASTExpr>(kid(0)), cast_or_null<ASTStmt>(kid(1)), cast_or_null<ASTStmt>(kid(2)));
+				break;
+			case NodeKind::ReturnStmt:
+				node = mArena.make<ASTReturnStmt>(cast_or_null<ASTExpr>(kid(0)));
+				break;
+			case NodeKind::WhileStmt:
+				node = mArena.make<ASTWhileStmt>(cast_or_null<ASTExpr>(kid(0)), cast_or_null<ASTStmt>(kid(1)));
+				break;
+			case NodeKind::ExprStmt:
+				node = mArena.make<ASTExprStmt>(cast_or_null<ASTExpr>(kid(0)));
+				break;
+			case NodeKind::NullStmt:
+				node = mArena.make<ASTNullStmt>();
+				break;
+			case NodeKind::IdentExpr:
+				node = mArena.make<ASTIdentExpr>(*ident);
+				break;
+			case NodeKind::ArrayExpr:
+				node = mArena.make<ASTArrayExpr>(*ident, cast_or_null<ASTExpr>(kid(0)));
+				break;
+			case NodeKind::FuncExpr: {
+				ASTFuncExpr * call = mArena.make<ASTFuncExpr>(*ident);
+
+				for (std::uint32_t n = 0; n < count; ++n) call->addArg(mArena, cast_or_null<ASTExpr>(kid(n)));
+
+				node = call;
+				break;
+			}
+			case NodeKind::AssignOp:
+			case NodeKind::LogicalAnd:
+			case NodeKind::LogicalOr:
+			case NodeKind::BinaryCmpOp:
+			case NodeKind::BinaryMathOp: {
+				ASTBinaryExpr * op = nullptr;
+
+				if (record.mKind == NodeKind::AssignOp) op = mArena.make<ASTAssignOp>(record.mOp);
+				else if (record.mKind == NodeKind::LogicalAnd) op = mArena.make<ASTLogicalAnd>();
+				else if (record.mKind == NodeKind::LogicalOr) op = mArena.make<ASTLogicalOr>();
+				else if (record.mKind == NodeKind::BinaryCmpOp) op = mArena.make<ASTBinaryCmpOp>(record.mOp);
+				else op = mArena.make<ASTBinaryMathOp>(record.mOp);
+
+				op->setLHS(cast_or_null<ASTExpr>(kid(0)));
+				op->setRHS(cast_or_null<ASTExpr>(kid(1)));
+
+				node = op;
+				break;
+			}
+			case NodeKind::NotExpr:
+				node = mArena.make<ASTNotExpr>(cast_or_null<ASTExpr>(kid(0)));
+				break;
+			case NodeKind::IncExpr:
+				node = mArena.make<ASTIncExpr>(*ident, cast_or_null<ASTExpr>(kid(0)));
+				break;
+			case NodeKind::DecExpr:
+				node = mArena.make<ASTDecExpr>(*ident, cast_or_null<ASTExpr>(kid(0)));
+				break;
+			case NodeKind::AddrOfArray:
+				node = mArena.make<ASTAddrOfArray>(cast_or_null<ASTArrayExpr>(kid(0)));
+				break;
+			case NodeKind::StringExpr:
+				node = mArena.make<ASTStringExpr>(text(mStrings[record.mRef].mText, mStrings[record.mRef].mLength), record.mRef, strings);
+				break;
+			case NodeKind::ConstantExpr:
+				node = mArena.make<ASTConstantExpr>(static_cast<int>(record.mInt));
+				break;
+			case NodeKind::DoubleExpr:
+				node = mArena.make<ASTDoubleExpr>(record.mDouble);
+				break;
+			case NodeKind::CharExpr: {
+				char value = static_cast<char>(record.mInt);
+
+				node = mArena.make<ASTCharExpr>(std::string_view(&value, 1));
+				break;
+			}
+			default:
+				break;
+		}
+
+		// types are taken as the parse left them instead of being worked out again, a call can come before the
+		// function it calls in post order
+		if (ASTExpr * expr = dyn_cast<ASTExpr>(node)) expr->mType = record.mType;
+
+		built[i] = node;
+	}
+
+	return cast<ASTProg>(built.back());
+}
@@ -0,0 +1,165 @@
+/*
+defines the binary AST cache i.e. class ASTCache which lets a compile of an unchanged source skip the scanner and the
+parser altogether
+
+the checked AST is flattened into a file of fixed size records that refer to each other by index instead of by
+address, so the file can be used straight out of mmap w/o a deserialization step (ASTCache::print walks it in place).
+codegen needs the arena AST so load() rebuilds it from the records in one pass, w/o scanning, parsing or checking
+anything. the file is keyed by a hash of the source and the options that change the AST
+
+layout, in native byte order w each section 8 byte aligned:
+    Header
+    Node[mNodes]        post order so every child comes before its parent and the ASTProg is last
+    uint32[mKids]       child lists, each node owns the run [mFirst, mFirst + mCount), None for a missing child
+    Ident[mIdents]      every Identifier the AST refers to
+    Str[mStrings]       the StringTable in the order its strings are first used
+    char[mText]         the names and string text the above point into
+*/
+
+#ifndef ASTCACHE_H
+#define ASTCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../scan/source.h"
+#include "astNodes.h"
+#include "symbols.h"
+
+// in parse.h
+class Parser;
+
+class ASTCache {
+public:
+	// bumped whenever the layout or the meaning of a record changes
+	static constexpr std::uint32_t Version = 2;
+
+	// child index of one that is not there e.g. the else of an if w/o one
+	static constexpr std::uint32_t None = UINT32_MAX;
+
+	struct Header {
+		char mMagic[4];
+		std::uint32_t mVersion;
+		std::uint64_t mKey;
+
+		// number of records in each section
+		std::uint32_t mNodes;
+		std::uint32_t mKids;
+		std::uint32_t mIdents;
+		std::uint32_t mStrings;
+		std::uint32_t mText;
+
+		// ident of printf if the program needs it declared, None if not
+		std::uint32_t mPrintf;
+		std::uint32_t mPad;
+
+		// hash of the rest of the file, one that was damaged on disk is a miss instead of a bad AST
+		std::uint64_t mChecksum;
+	};
+
+	struct Node {
+		NodeKind mKind;
+
+		// type of an expression, return type of a function
+		Type mType;
+
+		// operator of a binary expression
+		TokenType mOp;
+		std::uint8_t mPad;
+
+		// ident the node names (or the Str of a StringExpr)
+		std::uint32_t mRef;
+
+		// children
+		std::uint32_t mFirst;
+		std::uint32_t mCount;
+
+		// value of a constant
+		union {
+			std::int64_t mInt;
+			double mDouble;
+		};
+	};
+
+	struct Ident {
+		std::uint32_t mName;
+		std::uint32_t mLength;
+		Type mType;
+		std::uint8_t mPad[3];
+		std::int32_t mElemCount;
+	};
+
+	struct Str {
+		std::uint32_t mText;
+		std::uint32_t mLength;
+	};
+
+	// key of source compiled w the options that shape its AST
+	static std::uint64_t key(const SourceBuffer& source, unsigned maxDepth, const std::vector<std::string>& roots) noexcept;
+
+	// file the AST for key is kept in under dir
+	static std::string path(const std::string& dir, std::uint64_t key);
+
+	// flatten the AST of a parse w/o errors into the file at path, returns false if it could not be written
+	// the file is written next to path and renamed over it so a compile reading it never sees half of one
+	static bool write(const std::string& path, std::uint64_t key, Parser& parser);
+
+	// map the file at path, isValid() is false if there is none or it is not an intact, well formed cache for key
+	ASTCache(const char * path, std::uint64_t key) noexcept;
+
+	~ASTCache() noexcept = default;
+
+	bool isValid() const noexcept {
+		return mValid;
+	}
+
+	// print the AST exactly like ASTProg::printNode but from the mapped records (in printNodes.cpp)
+	void print(std::ostream& output) const noexcept;
+
+	// rebuild the AST for codegen, the nodes and identifiers belong to the cache and the strings are added to strings
+	ASTProg * load(StringTable& strings) noexcept;
+
+	// the printf identifier of the loaded AST if the program needs it declared, otherwise nullptr
+	Identifier * getPrintf() const noexcept {
+		return mHeader->mPrintf == None || mIdentifiers.empty() ? nullptr : mIdentifiers[mHeader->mPrintf];
+	}
+private:
+	// false unless every record is in bounds and every child is of a kind its parent can hold, i.e. the records can
+	// be walked w/o reading outside of the file. what they say is trusted like the parse that wrote them
+	bool check() const noexcept;
+
+	// children of node in the order they are stored, nullptr for a missing one (in astCache.cpp)
+	static void children(const ASTNode * node, std::vector<const ASTNode *>& out) noexcept;
+
+	std::string_view text(std::uint32_t offset, std::uint32_t length) const noexcept {
+		return std::string_view(mText + offset, length);
+	}
+
+	// the cache file
+	SourceBuffer mFile;
+
+	// sections of mFile
+	const Header * mHeader;
+	const Node * mNodes;
+	const std::uint32_t * mKids;
+	const Ident * mIdents;
+	const Str * mStrings;
+	const char * mText;
+
+	bool mValid;
+
+	// the loaded AST
+	Arena mArena;
+
+	// every loaded function refers to this one, scopes only matter to the parser
+	ScopeTable mScope;
+
+	// in mArena
+	std::vector<Identifier *> mIdentifiers;
+};
+
+#endif
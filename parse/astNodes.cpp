@@ -1,13 +1,13 @@
 #include "astNodes.h"
 
 // add a function to the program
-void ASTProg::addFunction(std::shared_ptr<ASTFunc> func) noexcept {
-	mFuncs.push_back(func);
+void ASTProg::addFunction(Arena& arena, ASTFunc * func) noexcept {
+	mFuncs.push_back(arena, func);
 }
 
 // add an argument to said function
-void ASTFunc::addArg(std::shared_ptr<ASTArgDecl> arg) noexcept {
-	mArgs.push_back(arg);
+void ASTFunc::addArg(Arena& arena, ASTArgDecl * arg) noexcept {
+	mArgs.push_back(arena, arg);
 }
 
 // returns true if the type passed in matches the argument
@@ -22,16 +22,20 @@ Type ASTFunc::getArgType(int argNum) const noexcept {
 	else return Type::Void;
 }
 
-void ASTFunc::setBody(std::shared_ptr<ASTCompoundStmt> body) noexcept {
+void ASTFunc::addCallee(Arena& arena, ASTFunc * callee) noexcept {
+	mCallees.push_back(arena, callee);
+}
+
+void ASTFunc::setBody(ASTCompoundStmt * body) noexcept {
 	mBody = body;
 }
 
-void ASTFuncExpr::addArg(std::shared_ptr<ASTExpr> arg) noexcept {
-	mArgs.push_back(arg);
+void ASTFuncExpr::addArg(Arena& arena, ASTExpr * arg) noexcept {
+	mArgs.push_back(arena, arg);
 }
 
-void ASTCompoundStmt::addStmt(std::shared_ptr<ASTStmt> stmt) noexcept {
-	mStmts.push_back(stmt);
+void ASTCompoundStmt::addStmt(Arena& arena, ASTStmt * stmt) noexcept {
+	mStmts.push_back(arena, stmt);
 }
 
 /* 
@@ -1,19 +1,22 @@
 /*
-defines all AST nodes used in the recursive descent parsing
+defines all AST nodes used in the recursive descent parsing, the NodeKind each one is tagged w and the isa/dyn_cast/cast
+helpers that go w it
 */
 
 #ifndef ASTNODES_H
 #define ASTNODES_H
 
-#include <memory>
-#include <vector>
+#include <cassert>
+#include <cstdint>
 #include "../scan/token.h"
+#include "arena.h"
 #include "types.h"
 #include "symbols.h"
 
 // each printNode method defined in printNodes.cpp
 // each finalizeOp method for each op defined in astNodes.cpp
 // each codegen method defined in ../emitIR/astEmit.cpp
+// ASTCache (see astCache.h) is a friend of each node w private members so it can flatten and rebuild them
 
 // forward declare llvm Value to make compiler happy 
 namespace llvm {
@@ -23,52 +26,156 @@ namespace llvm {
 // in ../emitIr/emitter.h
 class CodeContext;
 
+// in astCache.h
+class ASTCache;
+
 // defined below just need to forward declare for compiler
 class ASTFunc;
 class ASTArgDecl;
 class ASTCompoundStmt;
 class ASTExpr;
 
+// one per concrete node, statements and expressions are kept together so ASTStmt and ASTExpr can check a range
+enum class NodeKind : std::uint8_t {
+	Prog,
+	Func,
+	ArgDecl,
+
+	// statements
+	Decl,
+	CompoundStmt,
+	IfStmt,
+	ReturnStmt,
+	ForStmt,
+	WhileStmt,
+	ExprStmt,
+	NullStmt,
+
+	// expressions
+	IdentExpr,
+	ArrayExpr,
+	FuncExpr,
+
+	// binary expressions (see ASTBinaryExpr::classof)
+	AssignOp,
+	LogicalAnd,
+	LogicalOr,
+	BinaryCmpOp,
+	BinaryMathOp,
+
+	// unary expressions and literals
+	NotExpr,
+	IncExpr,
+	DecExpr,
+	AddrOfArray,
+	StringExpr,
+	ConstantExpr,
+	DoubleExpr,
+	CharExpr
+};
+
+// nodes are allocated in the Parsers Arena (see arena.h) so they must not own any memory
+//
+// every node is tagged w its NodeKind so a pass can test for or switch on the concrete node w/o RTTI, each class
+// has a classof for the isa/dyn_cast/cast helpers below
 class ASTNode {
 public:
 	// virtual so subclass deconstructors get called too
     virtual ~ASTNode() noexcept = default;
 
+	NodeKind getKind() const noexcept {
+		return mKind;
+	}
+
 	// each node should have a printNode method to make sure AST is well formed
 	virtual void printNode(std::ostream& output, int depth = 0) const noexcept = 0;	
 
 	// each node should have a codegen method to output LLVM LIR  
 	virtual llvm::Value * codegen(CodeContext& context) noexcept = 0; 
 protected:
-	ASTNode() noexcept = default;
+	ASTNode(NodeKind kind) noexcept
+	: mKind {kind} { }
+private:
+	NodeKind mKind;
 };
 
+// LLVM style casts on the node kind, dyn_cast gives back nullptr if node is not a T and cast asserts node is one
+template <typename T>
+bool isa(const ASTNode * node) noexcept {
+	return T::classof(node);
+}
+
+template <typename T>
+T * dyn_cast(ASTNode * node) noexcept {
+	return node && T::classof(node) ? static_cast<T *>(node) : nullptr;
+}
+
+template <typename T>
+const T * dyn_cast(const ASTNode * node) noexcept {
+	return node && T::classof(node) ? static_cast<const T *>(node) : nullptr;
+}
+
+// node must be a T
+template <typename T>
+T * cast(ASTNode * node) noexcept {
+	assert(node && T::classof(node) && "cast<T>() on a node of another kind");
+
+	return static_cast<T *>(node);
+}
+
+// same but nullptr (e.g. an if w/o an else) is passed through
+template <typename T>
+T * cast_or_null(ASTNode * node) noexcept {
+	return node ? cast<T>(node) : nullptr;
+}
+
 class ASTProg : public ASTNode { 
 public:
-	ASTProg() noexcept = default;
+	friend class ASTCache;
+
+	ASTProg() noexcept
+	: ASTNode {NodeKind::Prog} { }
 	~ASTProg() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::Prog;
+	}
+
 	// defined in astNodes.cpp
-    void addFunction(std::shared_ptr<ASTFunc> func) noexcept;
+    void addFunction(Arena& arena, ASTFunc * func) noexcept;
+
+    const ArenaVector<ASTFunc *>& getFunctions() const noexcept {
+        return mFuncs;
+    }
 
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override; 
 private: 
-    std::vector<std::shared_ptr<ASTFunc>> mFuncs;
+    ArenaVector<ASTFunc *> mFuncs;
 };
 
 class ASTFunc : public ASTNode {
 public:
-    ASTFunc(Identifier& ident, Type returnType, ScopeTable& scopeTable) noexcept
-    : mIdent {ident}
+	friend class ASTCache;
+
+    // index is the number of functions declared before this one
+    ASTFunc(Identifier& ident, Type returnType, ScopeTable& scopeTable, std::size_t index) noexcept
+    : ASTNode {NodeKind::Func}
+    , mIdent {ident}
     , mReturnType {returnType}
-    , mScopeTable {scopeTable} { }
+    , mScopeTable {scopeTable}
+    , mIndex {index} { }
 
 	~ASTFunc() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::Func;
+	}
+
 	// defined in astNodes.cpp
-    void addArg(std::shared_ptr<ASTArgDecl> arg) noexcept;
-    void setBody(std::shared_ptr<ASTCompoundStmt> body) noexcept;
+    void addArg(Arena& arena, ASTArgDecl * arg) noexcept;
+    void addCallee(Arena& arena, ASTFunc * callee) noexcept;
+    void setBody(ASTCompoundStmt * body) noexcept;
     bool checkArgType(int argNum, Type type) const noexcept;
     Type getArgType(int argNum) const noexcept;
 
@@ -82,22 +189,44 @@ public:
     int getNumArgs() const noexcept {
         return mArgs.size();
     }
+
+    std::size_t getIndex() const noexcept {
+        return mIndex;
+    }
+
+    ScopeTable& getScopeTable() const noexcept {
+        return mScopeTable;
+    }
+
+    // the function called by each ASTFuncExpr in the body i.e. the edges of the call graph
+    const ArenaVector<ASTFunc *>& getCallees() const noexcept {
+        return mCallees;
+    }
 protected:
-    std::vector<std::shared_ptr<ASTArgDecl>> mArgs;
-    std::shared_ptr<ASTCompoundStmt> mBody;
+    ArenaVector<ASTArgDecl *> mArgs;
+    ArenaVector<ASTFunc *> mCallees;
+    ASTCompoundStmt * mBody = nullptr;
 private:
     Identifier& mIdent;
     Type mReturnType;
     ScopeTable& mScopeTable;
+    std::size_t mIndex;
 };
 
 class ASTArgDecl : public ASTNode {
 public:
+	friend class ASTCache;
+
 	ASTArgDecl(Identifier& ident) noexcept
-	: mIdent {ident} { }
+	: ASTNode {NodeKind::ArgDecl}
+	, mIdent {ident} { }
 	
 	~ASTArgDecl() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::ArgDecl;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 
@@ -121,120 +250,182 @@ statements
 class ASTStmt : public ASTNode {
 public:
     virtual ~ASTStmt() noexcept = default;
+
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() >= NodeKind::Decl && node->getKind() <= NodeKind::NullStmt;
+	}
 protected:
-	ASTStmt() noexcept = default;
+	ASTStmt(NodeKind kind) noexcept
+	: ASTNode {kind} { }
 };
 
 class ASTDecl : public ASTStmt {
 public:
-	ASTDecl(Identifier& ident, std::shared_ptr<ASTExpr> expr = nullptr) noexcept
-	: mIdent {ident}
+	friend class ASTCache;
+
+	ASTDecl(Identifier& ident, ASTExpr * expr = nullptr) noexcept
+	: ASTStmt {NodeKind::Decl}
+	, mIdent {ident}
 	, mExpr {expr} { }
 
 	~ASTDecl() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::Decl;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
 	Identifier& mIdent;
-	std::shared_ptr<ASTExpr> mExpr;
+	ASTExpr * mExpr = nullptr;
 };
 
 class ASTCompoundStmt : public ASTStmt {
 public:
-	ASTCompoundStmt() noexcept = default;
+	friend class ASTCache;
+
+	ASTCompoundStmt() noexcept
+	: ASTStmt {NodeKind::CompoundStmt} { }
 	~ASTCompoundStmt() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::CompoundStmt;
+	}
+
 	// defined in astNodes.cpp
-	void addStmt(std::shared_ptr<ASTStmt> stmt) noexcept;
+	void addStmt(Arena& arena, ASTStmt * stmt) noexcept;
 
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-	std::vector<std::shared_ptr<ASTStmt>> mStmts;
+	ArenaVector<ASTStmt *> mStmts;
 };
 
 class ASTIfStmt : public ASTStmt {
 public:
-	ASTIfStmt(std::shared_ptr<ASTExpr> expr, std::shared_ptr<ASTStmt> thenStmt, std::shared_ptr<ASTStmt> elseStmt = nullptr) noexcept
-	: mExpr {expr}
+	friend class ASTCache;
+
+	ASTIfStmt(ASTExpr * expr, ASTStmt * thenStmt, ASTStmt * elseStmt = nullptr) noexcept
+	: ASTStmt {NodeKind::IfStmt}
+	, mExpr {expr}
 	, mThenStmt {thenStmt}
 	, mElseStmt {elseStmt} { }
 
 	~ASTIfStmt() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::IfStmt;
+	}
+
+	// the parser hooks each if of an else if chain up to the one before it
+	void setElseStmt(ASTStmt * elseStmt) noexcept {
+		mElseStmt = elseStmt;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-	std::shared_ptr<ASTExpr> mExpr;
-	std::shared_ptr<ASTStmt> mThenStmt;
-	std::shared_ptr<ASTStmt> mElseStmt;
+	ASTExpr * mExpr = nullptr;
+	ASTStmt * mThenStmt = nullptr;
+	ASTStmt * mElseStmt = nullptr;
 };
 
 class ASTReturnStmt : public ASTStmt {
 public:
-	ASTReturnStmt(std::shared_ptr<ASTExpr> expr) noexcept
-	: mExpr {expr} { }
+	friend class ASTCache;
+
+	ASTReturnStmt(ASTExpr * expr) noexcept
+	: ASTStmt {NodeKind::ReturnStmt}
+	, mExpr {expr} { }
 
 	~ASTReturnStmt() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::ReturnStmt;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-	std::shared_ptr<ASTExpr> mExpr;
+	ASTExpr * mExpr = nullptr;
 };
 
 class ASTForStmt : public ASTStmt {
 public:
-	ASTForStmt(std::shared_ptr<ASTStmt> varDef, std::shared_ptr<ASTStmt> cond, std::shared_ptr<ASTExpr> update, std::shared_ptr<ASTStmt> loopStmt) noexcept
-    : mVarDecl {varDef}
+	ASTForStmt(ASTStmt * varDef, ASTStmt * cond, ASTExpr * update, ASTStmt * loopStmt) noexcept
+    : ASTStmt {NodeKind::ForStmt}
+    , mVarDecl {varDef}
     , mExprCond {cond}
     , mUpdateStmt {update}
 	, mLoopBody {loopStmt} { }
 
 	~ASTForStmt() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::ForStmt;
+	}
+
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-    std::shared_ptr<ASTStmt> mVarDecl;
-	std::shared_ptr<ASTStmt> mExprCond;
-    std::shared_ptr<ASTExpr> mUpdateStmt;
-	std::shared_ptr<ASTStmt> mLoopBody;
+    ASTStmt * mVarDecl = nullptr;
+	ASTStmt * mExprCond = nullptr;
+    ASTExpr * mUpdateStmt = nullptr;
+	ASTStmt * mLoopBody = nullptr;
 };
 
 class ASTWhileStmt : public ASTStmt {
 public:
-	ASTWhileStmt(std::shared_ptr<ASTExpr> expr, std::shared_ptr<ASTStmt> loopStmt) noexcept
-	: mExpr {expr}
+	friend class ASTCache;
+
+	ASTWhileStmt(ASTExpr * expr, ASTStmt * loopStmt) noexcept
+	: ASTStmt {NodeKind::WhileStmt}
+	, mExpr {expr}
 	, mLoopStmt {loopStmt} { }
 
 	~ASTWhileStmt() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::WhileStmt;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-	std::shared_ptr<ASTExpr> mExpr;
-	std::shared_ptr<ASTStmt> mLoopStmt;
+	ASTExpr * mExpr = nullptr;
+	ASTStmt * mLoopStmt = nullptr;
 };
 
 class ASTExprStmt : public ASTStmt {
 public:
-	ASTExprStmt(std::shared_ptr<ASTExpr> expr) noexcept
-	: mExpr(expr) { }
+	friend class ASTCache;
+
+	ASTExprStmt(ASTExpr * expr) noexcept
+	: ASTStmt {NodeKind::ExprStmt}
+	, mExpr(expr) { }
 
 	~ASTExprStmt() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::ExprStmt;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-	std::shared_ptr<ASTExpr> mExpr;
+	ASTExpr * mExpr = nullptr;
 };
 
 class ASTNullStmt : public ASTStmt {
 public:
-	ASTNullStmt() noexcept = default;
+	ASTNullStmt() noexcept
+	: ASTStmt {NodeKind::NullStmt} { }
 	~ASTNullStmt() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::NullStmt;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 };
@@ -247,14 +438,21 @@ expressions
 // use as base class so no need to implement printNode since derived class will implement printNode
 class ASTExpr : public ASTNode {
 public:	
+	friend class ASTCache;
+
 	virtual ~ASTExpr() noexcept = default;
 
 	Type getType() const noexcept {
 		return mType;
 	}
+
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() >= NodeKind::IdentExpr && node->getKind() <= NodeKind::CharExpr;
+	}
 protected:
-	ASTExpr() noexcept
-	: mType {Type::Void} { }
+	ASTExpr(NodeKind kind) noexcept
+	: ASTNode {kind}
+	, mType {Type::Void} { }
 
 	// all expressions have a type
 	Type mType;
@@ -263,13 +461,20 @@ protected:
 // id
 class ASTIdentExpr : public ASTExpr {
 public:
+	friend class ASTCache;
+
 	ASTIdentExpr(Identifier& ident) noexcept
-	: mIdent {ident} {
+	: ASTExpr {NodeKind::IdentExpr}
+	, mIdent {ident} {
 		mType = mIdent.getType();
 	}
 
 	~ASTIdentExpr() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::IdentExpr;
+	}
+
 	llvm::Value * getAddress() const noexcept {
 		return mIdent.getAddress();
 	}
@@ -283,8 +488,11 @@ private:
 // id [ Expr ]
 class ASTArrayExpr : public ASTExpr {
 public:
-	ASTArrayExpr(Identifier& ident, std::shared_ptr<ASTExpr> expr) noexcept
-	: mExpr {expr}
+	friend class ASTCache;
+
+	ASTArrayExpr(Identifier& ident, ASTExpr * expr) noexcept
+	: ASTExpr {NodeKind::ArrayExpr}
+	, mExpr {expr}
 	, mIdent {ident}
 	, mIndexLoc {nullptr} {
 		switch (ident.getType()) {
@@ -304,6 +512,10 @@ public:
 
 	~ASTArrayExpr() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::ArrayExpr;
+	}
+
 	void setIndexLoc(llvm::Value * val) noexcept {
 		mIndexLoc = val;
 	}
@@ -316,48 +528,83 @@ public:
 		return mIdent.getAddress();
 	}
 
-	std::shared_ptr<ASTExpr> getExpr() const noexcept {
+	ASTExpr * getExpr() const noexcept {
 		return mExpr;
 	}
 
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-	std::shared_ptr<ASTExpr> mExpr;
+	ASTExpr * mExpr = nullptr;
 	Identifier& mIdent;
 	llvm::Value * mIndexLoc;
 };
 
-// lhs (+=, -=, =) rhs
-class ASTAssignOp : public ASTExpr {
+// lhs op rhs, the operators share this base so a walk can follow a chain of them down the left side in a loop
+// e.g. a + b + c + ... from a code generator is as deep as it is long (see printNodes.cpp and ../emitIR/astEmit.cpp)
+class ASTBinaryExpr : public ASTExpr {
 public:
-	ASTAssignOp(TokenType t) noexcept
-	: mOp {t} { }
+	virtual ~ASTBinaryExpr() noexcept = default;
 
-	~ASTAssignOp() noexcept = default;
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() >= NodeKind::AssignOp && node->getKind() <= NodeKind::BinaryMathOp;
+	}
 
-	void setLHS(std::shared_ptr<ASTExpr> lhs) noexcept {
+	TokenType getOp() const noexcept {
+		return mOp;
+	}
+
+	ASTExpr * getLHS() const noexcept {
+		return mLHS;
+	}
+
+	ASTExpr * getRHS() const noexcept {
+		return mRHS;
+	}
+
+	void setLHS(ASTExpr * lhs) noexcept {
 		mLHS = lhs;
 	}
 
-	void setRHS(std::shared_ptr<ASTExpr> rhs) noexcept {
+	void setRHS(ASTExpr * rhs) noexcept {
 		mRHS = rhs;
 	}
 
-	bool finalizeOp() noexcept;	
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
-	llvm::Value * codegen(CodeContext& context) noexcept override;
-private:
+protected:
+	ASTBinaryExpr(NodeKind kind, TokenType op) noexcept
+	: ASTExpr {kind}
+	, mOp {op} { }
+
 	TokenType mOp;
-	std::shared_ptr<ASTExpr> mLHS;
-	std::shared_ptr<ASTExpr> mRHS;
+	ASTExpr * mLHS = nullptr;
+	ASTExpr * mRHS = nullptr;
+};
+
+// lhs (+=, -=, =) rhs
+class ASTAssignOp : public ASTBinaryExpr {
+public:
+	ASTAssignOp(TokenType t) noexcept
+	: ASTBinaryExpr {NodeKind::AssignOp, t} { }
+
+	~ASTAssignOp() noexcept = default;
+
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::AssignOp;
+	}
+
+	bool finalizeOp() noexcept;	
+	llvm::Value * codegen(CodeContext& context) noexcept override;
 };
 
 // id ( FuncCallArgs )
 class ASTFuncExpr : public ASTExpr {
 public:
+	friend class ASTCache;
+
 	ASTFuncExpr(Identifier& ident) noexcept
-	: mIdent {ident} {
+	: ASTExpr {NodeKind::FuncExpr}
+	, mIdent {ident} {
 		if (mIdent.getFunction()) {
 			mType = mIdent.getFunction()->getReturnType();
 		} else {
@@ -366,185 +613,193 @@ public:
 	}
 	
 	~ASTFuncExpr() noexcept = default;
+
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::FuncExpr;
+	}
 	
 	int getNumArgs() const noexcept {
 		return mArgs.size();
 	}
 
-	void addArg(std::shared_ptr<ASTExpr> arg) noexcept;	
+	void addArg(Arena& arena, ASTExpr * arg) noexcept;	
 	virtual void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
 	Identifier& mIdent;
-	std::vector<std::shared_ptr<ASTExpr>> mArgs;
+	ArenaVector<ASTExpr *> mArgs;
 };
 
-class ASTLogicalAnd : public ASTExpr {
+class ASTLogicalAnd : public ASTBinaryExpr {
 public:
-	ASTLogicalAnd() noexcept = default;
+	ASTLogicalAnd() noexcept
+	: ASTBinaryExpr {NodeKind::LogicalAnd, TokenType::And} { }
 	~ASTLogicalAnd() noexcept = default;
 
-	void setLHS(std::shared_ptr<ASTExpr> lhs) noexcept {
-		mLHS = lhs;
-	}
-
-	void setRHS(std::shared_ptr<ASTExpr> rhs) noexcept {
-		mRHS = rhs;
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::LogicalAnd;
 	}
 
 	bool finalizeOp() noexcept;	
-	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
-private:
-	std::shared_ptr<ASTExpr> mLHS;
-	std::shared_ptr<ASTExpr> mRHS;
 };
 
-class ASTLogicalOr : public ASTExpr {
+class ASTLogicalOr : public ASTBinaryExpr {
 public:
-	ASTLogicalOr() noexcept = default;
+	ASTLogicalOr() noexcept
+	: ASTBinaryExpr {NodeKind::LogicalOr, TokenType::Or} { }
 	~ASTLogicalOr() noexcept = default;
 
-	void setLHS(std::shared_ptr<ASTExpr> lhs) noexcept {
-		mLHS = lhs;
-	}
-
-	void setRHS(std::shared_ptr<ASTExpr> rhs) noexcept {
-		mRHS = rhs;
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::LogicalOr;
 	}
 
 	bool finalizeOp() noexcept;	
-	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
-private:
-	std::shared_ptr<ASTExpr> mLHS;
-	std::shared_ptr<ASTExpr> mRHS;
 };
 
-class ASTBinaryCmpOp : public ASTExpr {
+class ASTBinaryCmpOp : public ASTBinaryExpr {
 public:
 	ASTBinaryCmpOp(TokenType op) noexcept
-	: mOp {op} { }
+	: ASTBinaryExpr {NodeKind::BinaryCmpOp, op} { }
 
 	~ASTBinaryCmpOp() noexcept = default; 
 
-	void setLHS(std::shared_ptr<ASTExpr> lhs) noexcept {
-		mLHS = lhs;
-	}
-
-	void setRHS(std::shared_ptr<ASTExpr> rhs) noexcept {
-		mRHS = rhs;
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::BinaryCmpOp;
 	}
 
 	bool finalizeOp() noexcept;	
-	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
-private:
-	TokenType mOp;
-	std::shared_ptr<ASTExpr> mLHS;
-	std::shared_ptr<ASTExpr> mRHS;
 };
 
-class ASTBinaryMathOp : public ASTExpr {
+class ASTBinaryMathOp : public ASTBinaryExpr {
 public:
 	ASTBinaryMathOp(TokenType op) noexcept
-	: mOp {op} { }
+	: ASTBinaryExpr {NodeKind::BinaryMathOp, op} { }
 
 	~ASTBinaryMathOp() noexcept = default; 
-	
-	void setLHS(std::shared_ptr<ASTExpr> lhs) noexcept {
-		mLHS = lhs;
-	}
 
-	void setRHS(std::shared_ptr<ASTExpr> rhs) noexcept {
-		mRHS = rhs;
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::BinaryMathOp;
 	}
 
 	bool finalizeOp() noexcept;	
-	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
-private:
-	TokenType mOp;
-	std::shared_ptr<ASTExpr> mLHS;
-	std::shared_ptr<ASTExpr> mRHS;
 };
 
 // !expr
 class ASTNotExpr : public ASTExpr {
 public:
-	ASTNotExpr(std::shared_ptr<ASTExpr> expr) noexcept
-	: mExpr {expr} {
+	friend class ASTCache;
+
+	ASTNotExpr(ASTExpr * expr) noexcept
+	: ASTExpr {NodeKind::NotExpr}
+	, mExpr {expr} {
 		mType = mExpr->getType();
 	}
 
 	~ASTNotExpr() noexcept = default; 
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::NotExpr;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-	std::shared_ptr<ASTExpr> mExpr;
+	ASTExpr * mExpr = nullptr;
 };
 
 // ++id
 class ASTIncExpr : public ASTExpr {
 public:
-	ASTIncExpr(Identifier& ident, std::shared_ptr<ASTExpr> expr) noexcept 
-	: mIdent {ident}
+	friend class ASTCache;
+
+	ASTIncExpr(Identifier& ident, ASTExpr * expr) noexcept 
+	: ASTExpr {NodeKind::IncExpr}
+	, mIdent {ident}
 	, mExpr {expr} {
 		mType = ident.getType();
 	}
 
 	~ASTIncExpr() noexcept = default; 
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::IncExpr;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
 	Identifier& mIdent;
-	std::shared_ptr<ASTExpr> mExpr;
+	ASTExpr * mExpr = nullptr;
 };
 
 // --id
 class ASTDecExpr : public ASTExpr {
 public:
-	ASTDecExpr(Identifier& ident, std::shared_ptr<ASTExpr> expr) noexcept 
-	: mIdent {ident}
+	friend class ASTCache;
+
+	ASTDecExpr(Identifier& ident, ASTExpr * expr) noexcept 
+	: ASTExpr {NodeKind::DecExpr}
+	, mIdent {ident}
 	, mExpr {expr} {
 		mType = ident.getType();
 	}
 
 	~ASTDecExpr() noexcept = default; 
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::DecExpr;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
 	Identifier& mIdent;	
-	std::shared_ptr<ASTExpr> mExpr;
+	ASTExpr * mExpr = nullptr;
 };
 
 class ASTAddrOfArray : public ASTExpr {
 public:
-	ASTAddrOfArray(std::shared_ptr<ASTArrayExpr> array) noexcept
-	: mArray {array} {
+	friend class ASTCache;
+
+	ASTAddrOfArray(ASTArrayExpr * array) noexcept
+	: ASTExpr {NodeKind::AddrOfArray}
+	, mArray {array} {
 		mType = mArray->getType();
 	}
 
 	~ASTAddrOfArray() noexcept = default; 
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::AddrOfArray;
+	}
+
 	void printNode(std::ostream& output, int depth = 0) const noexcept override;
 	llvm::Value * codegen(CodeContext& context) noexcept override;
 private:
-	std::shared_ptr<ASTArrayExpr> mArray;
+	ASTArrayExpr * mArray = nullptr;
 };
 
 class ASTStringExpr : public ASTExpr {
 public:
-	ASTStringExpr(std::string& str, StringTable& tbl) noexcept
-	: mString {tbl.getString(str)} {
+	friend class ASTCache;
+
+	// offset of the literal in the source (see StringTable::getString)
+	ASTStringExpr(std::string_view str, std::size_t offset, StringTable& tbl) noexcept
+	: ASTExpr {NodeKind::StringExpr}
+	, mString {tbl.getString(str, offset)} {
 		mType = Type::CharArray;
 	}
 
 	~ASTStringExpr() noexcept = default; 
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::StringExpr;
+	}
+
 	int getLength() const noexcept {
 		return mString->getText().size();
 	}	
@@ -557,12 +812,18 @@ private:
 
 class ASTConstantExpr : public ASTExpr {
 public:
-	ASTConstantExpr(const std::string& constStr) noexcept
-    : mValue {std::stoi(constStr)} {
+	// value was parsed by the scanner
+	ASTConstantExpr(int value) noexcept
+    : ASTExpr {NodeKind::ConstantExpr}
+    , mValue {value} {
 		mType = Type::Int;
 	}
 
 	~ASTConstantExpr() noexcept = default;
+
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::ConstantExpr;
+	}
 	
 	int getValue() const noexcept {
 		return mValue;
@@ -576,13 +837,18 @@ private:
 
 class ASTDoubleExpr : public ASTExpr {
 public:
-	ASTDoubleExpr(const std::string& constStr)
-	: mValue {std::stod(constStr)} {
+	ASTDoubleExpr(double value) noexcept
+	: ASTExpr {NodeKind::DoubleExpr}
+	, mValue {value} {
 		mType = Type::Double;
 	}
 
 	~ASTDoubleExpr() noexcept = default;
 
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::DoubleExpr;
+	}
+
 	double getValue() const noexcept {
 		return mValue;
 	}
@@ -595,12 +861,17 @@ private:
 
 class ASTCharExpr : public ASTExpr {
 public:
-	ASTCharExpr(const std::string& constStr) 
-	: mValue {constStr[0]}{
+	ASTCharExpr(std::string_view constStr) 
+	: ASTExpr {NodeKind::CharExpr}
+	, mValue {constStr.empty() ? '\0' : constStr[0]}{
 		mType = Type::Char;
 	}
 
 	~ASTCharExpr() noexcept = default;
+
+	static bool classof(const ASTNode * node) noexcept {
+		return node->getKind() == NodeKind::CharExpr;
+	}
 	
 	char getValue() const noexcept {
 		return mValue;
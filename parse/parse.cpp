@@ -1,14 +1,22 @@
+#include <algorithm>
 #include <iostream>
+#include <thread>
 #include "../scan/scan.h"
-#include "../error/parseExcept.h"
+#include "../error/syntaxError.h"
 #include "astNodes.h"
 #include "symbols.h"
 #include "parse.h"
 
-Parser::Parser(Scanner& scanner, SymbolTable& table, StringTable& strings, const char * fileName, std::ostream * errStream, std::ostream * astStream) 
+namespace {
+
+// what the parser reads once -ferror-limit is hit, only ever read so the workers can share it
+Token sLimitEnd {TokenType::EndOfFile, {}, SIZE_MAX};
+
+}
+
+Parser::Parser(Scanner& scanner, SymbolTable& table, StringTable& strings, const char * fileName, std::ostream * errStream, std::ostream * astStream, Options options) 
 : mScanner {scanner}
-, mCurrToken {scanner.mTokens[0]}
-, mTokenIndex {0}
+, mCurrToken {&scanner.peekToken()}
 , mErrors {}
 , mFileName {fileName}
 , mErrStream {errStream}
@@ -16,68 +24,141 @@ Parser::Parser(Scanner& scanner, SymbolTable& table, StringTable& strings, const
 , mSymbolTable {table}
 , mStringTable {strings}
 , mCurrReturnType {Type::Void}
-, mNeedPrintf {false} {
-    try {
-		mRoot = parseProgram();
-    } catch (ParseExcept& e) {
-        reportError(e);
-    }
-
-    if (!isValid()) {
+, mCurrFunc {nullptr}
+, mNeedPrintf {false}
+, mExprEngine {options.mEngine}
+#ifdef CRISP_PARSE_STATS
+, mExprCount {0}
+, mExprCalls {0}
+#endif
+, mPanic {false}
+, mErrorAt {SIZE_MAX}
+, mErrorLimit {options.mErrorLimit}
+, mErrorsDropped {false}
+, mArena {}
+, mMaxDepth {options.mMaxDepth}
+, mDepth {0}
+, mOpenBlocks {}
+, mFuncCount {0}
+, mVisibleFuncs {SIZE_MAX}
+, mThreads {options.mThreads ? options.mThreads : std::max(1u, std::thread::hardware_concurrency())}
+, mBodies {}
+, mNextBody {0}
+, mJobs {}
+, mViews {}
+, mRoots {std::move(options.mRoots)}
+, mMissingRoots {}
+, mRoot {nullptr} {
+	// the pre-pass needs all of the tokens up front
+	if ((mThreads > 1 || !mRoots.empty()) && !scanner.mStreaming) skimBodies();
+
+	if (!mRoots.empty()) markLive();
+
+	mRoot = parseProgram();
+
+	// the bodies the program parse left for the workers, their errors come before the ones after them so they are
+	// parsed even if the program parse went past the error limit (it left no bodies past that point)
+	if (!mJobs.empty()) parseBodies();
+
+	if (!mRoots.empty()) dropUnreachable();
+
+    if (!mErrors.empty()) {
         displayErrors();
     }
 }
 
+Parser::Parser(Scanner& scanner, SymbolTable& table, StringTable& strings, const char * fileName, std::ostream * errStream, std::ostream * astStream)
+: Parser {scanner, table, strings, fileName, errStream, astStream, Options {}} { }
+
+Parser::Parser(Parser& parent, Scanner& reader, SymbolTable& view) noexcept
+: mScanner {reader}
+, mCurrToken {&reader.peekToken()}
+, mErrors {}
+, mFileName {parent.mFileName}
+, mErrStream {parent.mErrStream}
+, mAstStream {parent.mAstStream}
+, mSymbolTable {view}
+, mStringTable {parent.mStringTable}
+, mCurrReturnType {Type::Void}
+, mCurrFunc {nullptr}
+, mNeedPrintf {false}
+, mExprEngine {parent.mExprEngine}
+#ifdef CRISP_PARSE_STATS
+, mExprCount {0}
+, mExprCalls {0}
+#endif
+, mPanic {false}
+, mErrorAt {SIZE_MAX}
+, mErrorLimit {parent.mErrorLimit}
+, mErrorsDropped {false}
+, mArena {}
+, mMaxDepth {parent.mMaxDepth}
+, mDepth {0}
+, mOpenBlocks {}
+, mFuncCount {0}
+, mVisibleFuncs {0}
+, mThreads {1}
+, mBodies {}
+, mNextBody {0}
+, mJobs {}
+, mViews {}
+, mRoots {}
+, mMissingRoots {}
+, mRoot {nullptr} { }
+
+Parser::~Parser() noexcept = default;
+
 /* 
 --------------------------------------------------------------------------------------------------------------
 methods used for error messages when parsing grammar and performing semantic analysis
 */
 
-void Parser::reportError(const ParseExcept& except) noexcept {
-	std::stringstream errStrm;
-	except.printException(errStrm);
-	mErrors.push_back(std::make_shared<Error>(errStrm.str(), mCurrToken.mLine, mCurrToken.mCol));
-}
-
+// line/col are only worked out from the token offset once there is an error
 void Parser::reportError(const std::string& msg) noexcept {
-	mErrors.push_back(std::make_shared<Error>(msg, mCurrToken.mLine, mCurrToken.mCol));
+	const LineTable& lines = mScanner.lines();
+
+	addError(msg, lines.line(mCurrToken->mOffset), lines.col(mCurrToken->mOffset));
 }
 
-void Parser::reportSemantError(const std::string& msg, int col) noexcept {
-	int c = (col == -1) ? mCurrToken.mCol : col;
+void Parser::addError(const std::string& msg, std::int64_t line, std::int64_t col) noexcept {
+	if (!mErrorLimit || mErrors.size() < mErrorLimit) {
+		mErrors.emplace_back(msg, line, col);
+		return;
+	}
 
-    mErrors.push_back(std::make_shared<Error>(msg, mCurrToken.mLine, c));
+	// the first error past the limit is dropped and the rest of the input reads as the end of the file so every rule
+	// unwinds w/o consuming anything, the errors that unwinding reports are dropped too
+	if (!mErrorsDropped) mCurrToken = &sLimitEnd;
+
+	mErrorsDropped = true;
 }
 
-void Parser::displayErrorMsg(const std::string& line, std::shared_ptr<Error> error) noexcept {
-    (*mErrStream) << mFileName << ":" << error->mLine << ":" << error->mCol;
-	(*mErrStream) << ": error: ";
-	(*mErrStream) << error->mMsg << std::endl;
-	
-	(*mErrStream) << line << std::endl;
-	
-    // now add the caret
-	for (int i = 0; i < error->mCol - 1; ++i) {
-		if (line[i] == '\t') (*mErrStream) << '\t';
-		else (*mErrStream) << ' ';
+// a syntax error stops the parse of everything up to the nearest recovery point so only the first one is reported
+void Parser::syntaxError(const std::string& msg) noexcept {
+	if (mPanic) return;
+
+	if (mCurrToken->mOffset != mErrorAt) {
+		reportError(msg);
+		mErrorAt = mCurrToken->mOffset;
 	}
 
-	(*mErrStream) << '^' << std::endl;
+	mPanic = true;
+}
+
+void Parser::reportSemantError(const std::string& msg) noexcept {
+	reportError(msg);
+}
+
+void Parser::reportSemantError(const std::string& msg, std::size_t offset) noexcept {
+	const LineTable& lines = mScanner.lines();
+
+    addError(msg, lines.line(mCurrToken->mOffset), lines.col(offset));
 }
 
 void Parser::displayErrors() noexcept {
-	int lineNum = 0;
-	std::string lineTxt;
-	std::ifstream fileStream(mFileName);
-	
-	for (auto i = mErrors.begin(); i != mErrors.end(); ++i) {
-		while (lineNum < (*i)->mLine) {
-			std::getline(fileStream, lineTxt);
-			lineNum++;
-		}
-		
-		displayErrorMsg(lineTxt, *i);
-	}
+	Diagnostics diagnostics {mFileName, mScanner.source(), mScanner.lines()};
+
+	diagnostics.render(*mErrStream, mErrors, mErrorsDropped ? mErrorLimit : 0);
 }
 
 const char * Parser::getTypeText(Type type) const noexcept {
@@ -108,45 +189,59 @@ const char * Parser::getTypeText(Type type) const noexcept {
 helper methods for parsing grammar 
 */
 
-Identifier * Parser::getVariable(const std::string& name) noexcept {
+Identifier * Parser::getVariable(Atom name) noexcept {
 	Identifier * ident = mSymbolTable.getIdentifier(name);
 
+	// a function declared after the one being parsed is already in the table when bodies are parsed in parallel
+	if (ident && ident->getFunction() && ident->getFunction()->getIndex() >= mVisibleFuncs) ident = nullptr;
+
 	if (!ident) {
-		reportSemantError("Use of undeclared identifier '" + name + "'");
-		return mSymbolTable.getIdentifier("@@variable");
+		std::string err("Use of undeclared identifier '");
+		err += Atoms::spelling(name);
+		err += '\'';
+
+		reportSemantError(err);
+		return mSymbolTable.getIdentifier(Atoms::Variable);
 	}
 	
 	return ident;
 }
 
-// returns true if we are past last scanned token in vector
+// returns true if we are past last scanned token
 bool Parser::isAtEnd() const noexcept {
-	return mCurrToken.mType == TokenType::EndOfFile;
+	return mCurrToken->mType == TokenType::EndOfFile;
 }
 
-// advance to next token in vector
+// advance to next token, in streaming mode this scans it
 void Parser::advance() noexcept {
 	if (isAtEnd()) return;
 	
-	mCurrToken = mScanner.mTokens[++mTokenIndex];
+	// just moves the cursor, the token itself stays in the scanners ring
+	mScanner.nextToken();
+	mCurrToken = &mScanner.peekToken();
+}
+
+const Token& Parser::peek(std::size_t n) noexcept {
+	return mScanner.peekToken(n);
 }
 
-// consumes the current token if arg is set to false then we throw exception for TokenType::Unkown
-// throws an exception if next token is Unknown and consumes it
-void Parser::consumeToken(bool unknownBad) {
+// consumes the current token if arg is set to false Unknown tokens are left for the caller
+// otherwise each Unknown token after it is reported and skipped so the parse carries on as if it was not there
+void Parser::consumeToken(bool unknownBad) noexcept {
 	advance();
 
-	if (unknownBad && mCurrToken.mType == TokenType::Unknown) {
-		throw UnknownToken(mCurrToken.mStr, mCurrToken.mCol);
-		consumeToken();
+	while (unknownBad && mCurrToken->mType == TokenType::Unknown) {
+		reportError(SyntaxError::unknownToken(mCurrToken->mStr));
+		advance();
+
+		mErrorAt = mCurrToken->mOffset;
 	}
 }
 
 // sees if the token matches the requested
 // if it does it will consume the token and return true otherwise it will return false
-// throws an exception if next token is Unknown
 bool Parser::peekAndConsume(TokenType desired) noexcept {
-	if (mCurrToken.mType == desired) {
+	if (mCurrToken->mType == desired) {
 		consumeToken();
 		return true;
 	}
@@ -154,56 +249,80 @@ bool Parser::peekAndConsume(TokenType desired) noexcept {
 	return false;
 }
 
-// returns true if the current token matches one of the tokens in the list
-bool Parser::peekIsOneOf(const std::vector<TokenType>& v) const noexcept {	
-	for (TokenType t : v) {
-		if (mCurrToken.mType == t) return true;
-	}
-
-	return false;
-}
-
 // matches the current token against the requested token and consumes it
-// throws an exception if there is a mismatch 
+// reports a syntax error and returns false if there is a mismatch
 // should only use this for terminals that are always a specific text
-void Parser::matchToken(TokenType desired) {
+bool Parser::matchToken(TokenType desired) noexcept {
 	if (!peekAndConsume(desired)) {
-		throw TokenMismatch(desired, mCurrToken.mType, mCurrToken.mStr);
+		syntaxError(SyntaxError::mismatch(desired, mCurrToken->mType, mCurrToken->mStr));
+		return false;
 	}
+
+	return true;
 }
 
 // matches the current token against the first element
-// in the vector and then consumes and verifies all
+// in the sequence and then consumes and verifies all
 // remaining requested elements
 //
-// throws an exception if there is a mismatch
-// since it throws an exception it should only be used in instances where a
+// reports a syntax error and returns false at the first mismatch
+// so it should only be used in instances where a
 // specific token order is the only valid match
-// it also throws an exception if the next token is Unknown
-void Parser::matchTokenSeq(const std::vector<TokenType>& v) {	
-	for (TokenType t : v) {
-		if (!peekAndConsume(t)) {
-			throw TokenMismatch(t, mCurrToken.mType, mCurrToken.mStr);
-		}
+bool Parser::matchTokenSeq(std::initializer_list<TokenType> seq) noexcept {	
+	for (TokenType t : seq) {
+		if (!matchToken(t)) return false;
 	}
+
+	return true;
 }
 
 // consumes tokens until either a match or EOF is found
 void Parser::consumeUntil(TokenType desired) noexcept {	
-	while (mCurrToken.mType != TokenType::EndOfFile && mCurrToken.mType != desired) {
+	while (mCurrToken->mType != TokenType::EndOfFile && mCurrToken->mType != desired) {
 		consumeToken(false);
 	}
 }
 
-// same thing as above but matches w a list of TokenTypes
-void Parser::consumeUntil(const std::vector<TokenType>& desired) noexcept {
-	if (mCurrToken.mType == TokenType::EndOfFile) return;
-	
-	while (mCurrToken.mType != TokenType::EndOfFile) {
-		for (TokenType t : desired) {
-			if (mCurrToken.mType == t) {
-				return;
-			}
+// same thing as above but matches any token in the set
+void Parser::consumeUntil(TokenSet desired) noexcept {
+	while (mCurrToken->mType != TokenType::EndOfFile && !desired.contains(mCurrToken->mType)) {
+		consumeToken(false);
+	}
+}
+
+// skip what is left of the broken rule up to a token that can follow it and carry on from there
+bool Parser::recover(TokenSet sync) noexcept {
+	// if we were already at the end the error that got us here said so
+	if (!isAtEnd()) {
+		consumeUntil(sync);
+
+		if (!isAtEnd()) {
+			mPanic = false;
+			return true;
+		}
+
+		if (!sync.contains(TokenType::EndOfFile)) reportError(SyntaxError::EndOfFile);
+	}
+
+	// out of tokens so keep unwinding, the rest of the recovery points just fall through
+	mPanic = true;
+	return false;
+}
+
+// the brackets opened from here on are skipped w everything in them and it stops at the closer of the innermost one
+// that was already open, so the recovery point above resyncs next to it instead of somewhere down in the nesting
+void Parser::tooDeep() noexcept {
+	syntaxError(SyntaxError::tooDeep(mMaxDepth));
+
+	std::size_t open = 0;
+
+	while (!isAtEnd()) {
+		if (peekIsOneOf(Grammar::OpenBrackets)) {
+			++open;
+		} else if (peekIsOneOf(Grammar::CloseBrackets)) {
+			if (open == 0) break;
+
+			--open;
 		}
 
 		consumeToken(false);
@@ -215,20 +334,21 @@ void Parser::consumeUntil(const std::vector<TokenType>& desired) noexcept {
 methods for recursive descent parsing other methods are in parse.cpp
 */
 
-std::shared_ptr<ASTProg> Parser::parseProgram() {
+ASTProg * Parser::parseProgram() {
 	// create our base program node
-	std::shared_ptr<ASTProg> retVal = std::make_shared<ASTProg>();
-	
-	// parse our function 
-	std::shared_ptr<ASTFunc> func = parseFunction();
-	
-	while (func) {
-		retVal->addFunction(func);
-		func = parseFunction();
-	}
+	ASTProg * retVal = mArena.make<ASTProg>();
 	
-	if (mCurrToken.mType != TokenType::EndOfFile) {
-		reportError("Expected end of file");
+	// parse our functions
+	while (!isAtEnd()) {
+		// something that is not a function
+		if (!peekIsOneOf(Grammar::FirstFunction)) syntaxError("Expected end of file");
+
+		ASTFunc * func = parseFunction();
+
+		if (func) retVal->addFunction(mArena, func);
+
+		// pick up again at the next function
+		if (mPanic && !recover(Grammar::FollowFunction)) break;
 	}
 	
 	// if (isValid()) {
@@ -242,13 +362,13 @@ std::shared_ptr<ASTProg> Parser::parseProgram() {
 	return retVal;
 }
 
-std::shared_ptr<ASTFunc> Parser::parseFunction() {
-	std::shared_ptr<ASTFunc> retVal;
+ASTFunc * Parser::parseFunction() {
+	ASTFunc * retVal = nullptr;
 
-	if (peekIsOneOf({TokenType::KeyVoid, TokenType::KeyDouble, TokenType::KeyInt, TokenType::KeyChar})) {		
+	if (peekIsOneOf(Grammar::FirstFunction)) {		
 		Type retType;
 
-		switch (mCurrToken.mType) {
+		switch (mCurrToken->mType) {
 			case TokenType::KeyInt:
 				retType = Type::Int;
 				break;
@@ -275,45 +395,37 @@ std::shared_ptr<ASTFunc> Parser::parseFunction() {
 
 			consumeUntil(TokenType::RBracket);
 
-			if (mCurrToken.mType == TokenType::EndOfFile) {
-				throw EOFExcept();
-			}
-			
-			matchToken(TokenType::RBracket);
+			if (!matchToken(TokenType::RBracket)) return nullptr;
 		}
 
 		Identifier * ident = nullptr;
-		if (mCurrToken.mType != TokenType::Identifier) { 
+		if (mCurrToken->mType != TokenType::Identifier) { 
 			std::string err = "Function name ";
-			err += mCurrToken.mStr;
+			err += mCurrToken->mStr;
 			err += " is invalid";
 
 			reportError(err);
 
 			// set to a bogus debug symbol so the parse continues
-			ident = mSymbolTable.getIdentifier("@@function");
+			ident = mSymbolTable.getIdentifier(Atoms::Function);
 
 			// skip until the open parenthesis
-			consumeUntil(TokenType::LParen);
-
-			if (mCurrToken.mType == TokenType::EndOfFile) {
-				throw EOFExcept();
-			}
+			if (!recover(TokenSet {TokenType::LParen})) return nullptr;
 		} else {
-			if (mSymbolTable.isDeclaredInScope(mCurrToken.mStr)) {
+			if (mSymbolTable.isDeclaredInScope(mCurrToken->mAtom)) {
 				// invalid redeclaration
 				std::string err = "Invalid redeclaration of function '";
-				err += mCurrToken.mStr;
+				err += mCurrToken->mStr;
 				err += '\'';
 
 				reportSemantError(err);
 
-				ident = mSymbolTable.getIdentifier("@@function");
+				ident = mSymbolTable.getIdentifier(Atoms::Function);
 			} else {
-				ident = mSymbolTable.createIdentifier(mCurrToken.mStr);
+				ident = mSymbolTable.createIdentifier(mCurrToken->mAtom);
 				ident->setType(Type::Function);
 				
-				if (ident->getName() == "main" && retType != Type::Int) {
+				if (ident->getAtom() == Atoms::Main && retType != Type::Int) {
 					reportSemantError("Function 'main' must return an int");
 				}
 			}
@@ -323,42 +435,36 @@ std::shared_ptr<ASTFunc> Parser::parseFunction() {
 
 		// once we are here it is time to enter the scope of the function
 		// since arguments count as the functions main body scope
-		ScopeTable * table = mSymbolTable.enterScope();
+		ScopeTable * table = mSymbolTable.enterFunction();
 
-		retVal = std::make_shared<ASTFunc>(*ident, retType, *table);
+		retVal = mArena.make<ASTFunc>(*ident, retType, *table, mFuncCount++);
+		mCurrFunc = retVal;
 		
 		if (!ident->isDummy()) {
 			ident->setFunction(retVal);
 		}
 
 		if (peekAndConsume(TokenType::LParen)) {
-			try {
-				std::shared_ptr<ASTArgDecl> arg = parseArgDecl();
+			ASTArgDecl * arg = parseArgDecl();
 
-				while (arg) {
-					retVal->addArg(arg);
+			while (arg) {
+				retVal->addArg(mArena, arg);
 
-					if (peekAndConsume(TokenType::Comma)) {
-						arg = parseArgDecl();
+				if (peekAndConsume(TokenType::Comma)) {
+					arg = parseArgDecl();
 
-						if (!arg) throw ParseExceptMsg("Additional function argument must follow a comma");
-					} else {
-						break;
-					}
+					if (!arg) syntaxError("Additional function argument must follow a comma");
+				} else {
+					break;
 				}
-			} catch (ParseExcept& e) {
-				reportError(e);
+			}
 
-				consumeUntil(TokenType::RParen);
+			if (!mPanic) matchToken(TokenType::RParen);
 
-				if (mCurrToken.mType == TokenType::EndOfFile) {
-					throw EOFExcept();
-				}
-			}
-			
-			matchToken(TokenType::RParen);
+			// resync on the ) or if that is missing the start of the body
+			if (mPanic && recover(Grammar::FollowArgList)) peekAndConsume(TokenType::RParen);
 
-			if (ident->getName() == "main" && retVal->getNumArgs() != 0) {
+			if (ident->getAtom() == Atoms::Main && retVal->getNumArgs() != 0) {
 				reportSemantError("Function 'main' cannot take any arguments");
 			}
 		} else {
@@ -368,37 +474,39 @@ std::shared_ptr<ASTFunc> Parser::parseFunction() {
 			reportError(err);
 
 			// skip until the compound stmt
-			consumeUntil(TokenType::LBrace);
-
-			if (mCurrToken.mType == TokenType::EndOfFile) {
-				throw EOFExcept();
-			}
+			recover(TokenSet {TokenType::LBrace});
 		}
 
 		// Grab the compound statement for this function
-		std::shared_ptr<ASTCompoundStmt> funcCompoundStmt;
-		try {
+		ASTCompoundStmt * funcCompoundStmt = nullptr;
+		const BodyRange * body = nullptr;
+		bool deferred = false;
+
+		if (mPanic) {
+			// nothing to do, the function is dropped below
+		} else if (mCurrToken->mType != TokenType::LBrace) {
+			syntaxError("Function implementation missing");
+		} else if ((body = bodyAt()) && !body->mLive) {
+			// nothing reaches it so it is declared but dropped w/o looking at the body
+			skipBody(*body);
+		} else if (body && mThreads > 1) {
+			deferBody(retVal, *body);
+			deferred = true;
+		} else {
 			funcCompoundStmt = parseCompoundStmt(true);
-		} catch (ParseExcept& e) {
-			// something bad happened here
-			reportError(e);
-
-			// skip all the tokens until the } brace
-			consumeUntil(TokenType::RBrace);
-
-			if (mCurrToken.mType == TokenType::EndOfFile) {
-				throw EOFExcept();
-			}
 
-			consumeToken();
+			// something bad happened here so skip all the tokens until the } brace
+			if (mPanic && recover(TokenSet {TokenType::RBrace})) consumeToken();
 		}
 
-		// exit the scope but before we potentially throw out of this function for a non-EOF message
+		// exit the scope before we potentially unwind out of this function
 		mSymbolTable.exitScope();
 
-		if (!funcCompoundStmt) {
-			throw ParseExceptMsg("Function implementation missing");
-		}
+		// a worker adds the body later
+		if (deferred) return retVal;
+
+		// a broken function is dropped
+		if (!funcCompoundStmt) return nullptr;
 
 		// add the compound statement to this function
 		retVal->setBody(funcCompoundStmt);
@@ -407,13 +515,13 @@ std::shared_ptr<ASTFunc> Parser::parseFunction() {
 	return retVal;
 }
 
-std::shared_ptr<ASTArgDecl> Parser::parseArgDecl() {
-	std::shared_ptr<ASTArgDecl> retVal;
+ASTArgDecl * Parser::parseArgDecl() {
+	ASTArgDecl * retVal = nullptr;
 	
-	if (peekIsOneOf({TokenType::KeyDouble, TokenType::KeyInt, TokenType::KeyChar})) {
+	if (peekIsOneOf(Grammar::FirstDecl)) {
 		Type varType = Type::Void;
 
-		switch (mCurrToken.mType) {
+		switch (mCurrToken->mType) {
 			case TokenType::KeyDouble:
 				varType = Type::Double;
 				break;
@@ -429,28 +537,29 @@ std::shared_ptr<ASTArgDecl> Parser::parseArgDecl() {
 		
 		consumeToken();
 		
-		if (mCurrToken.mType != TokenType::Identifier) {
-			throw ParseExceptMsg("Unnamed function parameters are not allowed");
+		if (mCurrToken->mType != TokenType::Identifier) {
+			syntaxError("Unnamed function parameters are not allowed");
+			return nullptr;
 		}
 		
 		// set it to the default "error" until we see if this is a new identifier
-		Identifier * ident = mSymbolTable.getIdentifier("@@variable");
+		Identifier * ident = mSymbolTable.getIdentifier(Atoms::Variable);
 
-		if (mSymbolTable.isDeclaredInScope(mCurrToken.mStr)) {
+		if (mSymbolTable.isDeclaredInScope(mCurrToken->mAtom)) {
 			std::string errMsg("Invalid redeclaration of argument '");
-			errMsg += mCurrToken.mStr;
+			errMsg += mCurrToken->mStr;
 			errMsg += '\'';
 
 			// leave at @@variable
 		} else {
-			ident = mSymbolTable.createIdentifier(mCurrToken.mStr);
+			ident = mSymbolTable.createIdentifier(mCurrToken->mAtom);
 		}
 		
 		consumeToken();
 		
 		// is this an array type?
 		if (peekAndConsume(TokenType::LBracket)) {
-			matchToken(TokenType::RBracket);
+			if (!matchToken(TokenType::RBracket)) return nullptr;
 
 			if (varType == Type::Int) varType = Type::IntArray;
 			else if (varType == Type::Char) varType = Type::CharArray;
@@ -459,10 +568,8 @@ std::shared_ptr<ASTArgDecl> Parser::parseArgDecl() {
 
 		ident->setType(varType);
 		
-		retVal = std::make_shared<ASTArgDecl>(*ident);
+		retVal = mArena.make<ASTArgDecl>(*ident);
 	}
 	
 	return retVal;
 }
-
-
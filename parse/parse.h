@@ -5,11 +5,27 @@ defines the parser i.e. class Parser which is used for recursive descent parsing
 #ifndef PARSE_H
 #define PARSE_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <fstream> 
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector> 
+#include "../error/diagnostics.h"
+#include "../scan/atoms.h"
+#include "arena.h"
+#include "tokenSet.h"
 #include "types.h"
 
+// counters behind the calls per expression figure of exprBench, only compiled in when bench/Makefile defines
+// CRISP_PARSE_STATS so the shipped parser does not pay for them
+#ifdef CRISP_PARSE_STATS
+#define PARSE_STAT(counter) (++(counter))
+#else
+#define PARSE_STAT(counter) ((void) 0)
+#endif
+
 // in ../scan/astNodes.h
 class ASTProg; class ASTFunc; class ASTArgDecl; class ASTDecl;
 class ASTStmt; class ASTIfStmt; class ASTForStmt; class ASTWhileStmt; 
@@ -18,10 +34,7 @@ class ASTExpr; class ASTAssignOp; class ASTLogicalOr; class ASTLogicalAnd; class
 class ASTBinaryMathOp; class ASTConstantExpr; class ASTCharExpr; class ASTStringExpr; class ASTDoubleExpr;
 
 // in ../scan/Token.h
-class Token; enum class TokenType;
-
-// in ../error/parseExcept.h
-class ParseExcept;
+class Token; enum class TokenType : std::uint8_t;
 
 // in ../scan/scan.h
 class Scanner;
@@ -32,116 +45,197 @@ class SymbolTable; class StringTable; class Identifier;
 class Parser {	
 public:
 	friend class Emitter;
+	friend class ASTCache;
+
+	// how expressions are parsed, both build the same AST so they can be A/B benchmarked
+	// Descent -> one recursive function per precedence level, Pratt -> precedence climbing over an operator table
+	enum class ExprEngine { Descent, Pratt };
+
+	// statements and expressions nested inside each other past this many levels are a syntax error
+	static constexpr unsigned DefaultMaxDepth = 256;
+
+	// highest budget the driver accepts, nested if/while statements and parentheses still recurse in the parser and
+	// in codegen once per level and the first of them to run out of an 8MB stack did so at about 11000 levels (-O0)
+	static constexpr unsigned MaxSafeDepth = 4096;
+
+	// how a source is parsed, the defaults are a serial parse of every function w no error limit
+	struct Options {
+		ExprEngine mEngine = ExprEngine::Pratt;
+
+		// != 1 parses the function bodies on that many threads (0 -> one per core) once every function is declared,
+		// this needs a batch scanned source, a streaming one is always parsed serially (see parseParallel.cpp)
+		unsigned mThreads = 1;
+
+		// caps how deep statements and expressions nest so a hostile input cant run the parser out of stack
+		unsigned mMaxDepth = DefaultMaxDepth;
+
+		// non empty only keeps the functions reachable from the ones it names (e.g. main or an export list), the
+		// bodies of the rest are skipped w/o being parsed when the source is batch scanned (see parseLazy.cpp)
+		std::vector<std::string> mRoots;
+
+		// != 0 stops the parse at the first error past this many, the rest of the input is not looked at
+		unsigned mErrorLimit = 0;
+	};
 
 	// start parsing by calling parseProgram()
-	// catch errors that reach constructor 
+	// syntax errors never throw, they are collected as the parse goes and resynced past (see recover())
 	// after parsing call displayErrors() to send error messages to stderr
+	Parser(Scanner& scanner, SymbolTable& table, StringTable& strings, const char * fileName, std::ostream * errStream, std::ostream * ASTStream, Options options);
+
+	// same w the default Options
 	Parser(Scanner& scanner, SymbolTable& table, StringTable& strings, const char * fileName, std::ostream * errStream, std::ostream * ASTStream);
 
-	~Parser() noexcept = default;
+	// defined in parse.cpp where the worker tables are complete
+	~Parser() noexcept;
 
     bool isValid() const noexcept {
-        return mErrors.size() == 0;
+        return mErrors.size() == 0 && mMissingRoots.empty();
+    }
+
+    // roots that name no function, the driver reports them as a mistake in its options
+    const std::vector<std::string>& getMissingRoots() const noexcept {
+        return mMissingRoots;
     }
 
     int getNumErrors() const noexcept {
         return mErrors.size();
     }
+
+	// root of the parsed program (null if the parse was cut short)
+	ASTProg * getRoot() const noexcept {
+		return mRoot;
+	}
+
+	// bytes the AST takes up in the arena
+	std::size_t getASTBytes() const noexcept {
+		return mArena.bytes();
+	}
+
+#ifdef CRISP_PARSE_STATS
+	// number of expressions parsed (every parseExpr call incl. nested ones)
+	std::size_t getExprCount() const noexcept {
+		return mExprCount;
+	}
+
+	// calls made through the precedence levels of the expression parser (parseFactor and up)
+	std::size_t getExprCalls() const noexcept {
+		return mExprCalls;
+	}
+#endif
 protected: 
 	// mutually recursive parse functions
 	
 	// entry point for parser (in parse.cpp)
-	std::shared_ptr<ASTProg> parseProgram();
+	ASTProg * parseProgram();
 	
 	// function definitions and/or forward declarations (in parse.cpp)
-	std::shared_ptr<ASTFunc> parseFunction();
-	std::shared_ptr<ASTArgDecl> parseArgDecl();
+	ASTFunc * parseFunction();
+	ASTArgDecl * parseArgDecl();
 
 	// declarations (in parseStmt.cpp)
-	std::shared_ptr<ASTDecl> parseDecl();
+	ASTDecl * parseDecl();
 
 	// statements (in parseStmt.cpp)
-	std::shared_ptr<ASTStmt> parseStmt();
+	ASTStmt * parseStmt();
 
 	// types of statements that parseStmt considers when parsing (in parseStmt.cpp)
-	std::shared_ptr<ASTIfStmt> parseIfStmt();
-	std::shared_ptr<ASTForStmt> parseForStmt();
-	std::shared_ptr<ASTWhileStmt> parseWhileStmt();
-	std::shared_ptr<ASTReturnStmt> parseReturnStmt();
-	std::shared_ptr<ASTExprStmt> parseExprStmt();
-	std::shared_ptr<ASTNullStmt> parseNullStmt();
+	ASTIfStmt * parseIfStmt();
+	ASTForStmt * parseForStmt();
+	ASTWhileStmt * parseWhileStmt();
+	ASTReturnStmt * parseReturnStmt();
+	ASTExprStmt * parseExprStmt();
+	ASTNullStmt * parseNullStmt();
 	// if the compound statement is a function body then the scope
 	// change will happen at a higher level so it should not happen in
 	// parseCompoundStmt
-	std::shared_ptr<ASTCompoundStmt> parseCompoundStmt(bool isFuncBody = false);
+	ASTCompoundStmt * parseCompoundStmt(bool isFuncBody = false);
+
+	// ( Expr ) Stmt after the if, parseIfStmt takes care of the else
+	ASTIfStmt * parseIfClause();
 
 	// expressions (in parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseExpr();
+	ASTExpr * parseExpr();
+
+	// Pratt parser for every binary operator that binds at least as tight as minPrec (in parseExpr.cpp)
+	ASTExpr * parseBinaryExpr(int minPrec);
 	
+	// the rest of the chain down to parseValue is the recursive descent parser used by ExprEngine::Descent, each
+	// Prime folds a run of its operators in a loop so a long chain does not take a stack frame per operator
+
 	// assignExpr (int parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseAssignExpr();
-	std::shared_ptr<ASTAssignOp> parseAssignExprPrime(std::shared_ptr<ASTExpr> lhs);
+	ASTExpr * parseAssignExpr();
+	ASTAssignOp * parseAssignExprPrime(ASTExpr * lhs);
 
 	// orTerm (int parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseOrTerm();
-	std::shared_ptr<ASTLogicalOr> parseOrTermPrime(std::shared_ptr<ASTExpr> lhs);
+	ASTExpr * parseOrTerm();
+	ASTLogicalOr * parseOrTermPrime(ASTExpr * lhs);
 
 	// andTerm (in parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseAndTerm();
-	std::shared_ptr<ASTLogicalAnd> parseAndTermPrime(std::shared_ptr<ASTExpr> lhs);
+	ASTExpr * parseAndTerm();
+	ASTLogicalAnd * parseAndTermPrime(ASTExpr * lhs);
 
 	// relExpr (in parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseRelExpr();
-	std::shared_ptr<ASTBinaryCmpOp> parseRelExprPrime(std::shared_ptr<ASTExpr> lhs);
+	ASTExpr * parseRelExpr();
+	ASTBinaryCmpOp * parseRelExprPrime(ASTExpr * lhs);
 	
 	// numExpr (in parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseNumExpr();
-	std::shared_ptr<ASTBinaryMathOp> parseNumExprPrime(std::shared_ptr<ASTExpr> lhs);
+	ASTExpr * parseNumExpr();
+	ASTBinaryMathOp * parseNumExprPrime(ASTExpr * lhs);
 	
 	// term (in parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseTerm();
-	std::shared_ptr<ASTBinaryMathOp> parseTermPrime(std::shared_ptr<ASTExpr> lhs);
+	ASTExpr * parseTerm();
+	ASTBinaryMathOp * parseTermPrime(ASTExpr * lhs);
 	
 	// value (in parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseValue();
+	ASTExpr * parseValue();
 	
 	// factor (in parseExpr.cpp)
-	std::shared_ptr<ASTExpr> parseFactor();
-	std::shared_ptr<ASTExpr> parseParenFactor();
-	std::shared_ptr<ASTConstantExpr> parseConstantFactor();
-	std::shared_ptr<ASTCharExpr> parseCharFactor();
-	std::shared_ptr<ASTStringExpr> parseStringFactor();
-	std::shared_ptr<ASTDoubleExpr> parseDoubleFactor();
+	ASTExpr * parseFactor();
+	ASTExpr * parseParenFactor();
+	ASTConstantExpr * parseConstantFactor();
+	ASTCharExpr * parseCharFactor();
+	ASTStringExpr * parseStringFactor();
+	ASTDoubleExpr * parseDoubleFactor();
 
 	// parseIdentFactor parses id, id [Expr], id (FunCallArgs), id [Expr] (+=, -=, =) Expr, id (+=, -=, =) Expr
-	std::shared_ptr<ASTExpr> parseIdentFactor();
-	std::shared_ptr<ASTExpr> parseIncFactor();
-	std::shared_ptr<ASTExpr> parseDecFactor();
-	std::shared_ptr<ASTExpr> parseAddrOfArrayFactor();
+	ASTExpr * parseIdentFactor();
+	ASTExpr * parseIncFactor();
+	ASTExpr * parseDecFactor();
+	ASTExpr * parseAddrOfArrayFactor();
 private:
-	// helper struct for displaying error messages
-	struct Error {
-        Error(const std::string& msg, int line, int col)
-        : mMsg(msg)
-        , mLine(line)
-        , mCol(col) { }
-        
-        std::string mMsg;
-        int mLine;
-        int mCol;
-    };
-
-	// scanner that stores the vector of tokens to parse
-	Scanner& mScanner;
+	// a top level { } found by the pre-pass, tokens [mOpen, mClose] of the batch scanned source
+	struct BodyRange {
+		std::size_t mOpen;
+		std::size_t mClose;
+
+		// false if no root can reach it so it is skipped
+		bool mLive;
+	};
+
+	// a function body left for a worker to parse
+	struct BodyJob {
+		ASTFunc * mFunc;
+		BodyRange mRange;
 
-	// current token to be considered
-	Token& mCurrToken;
+		// errors reported before the body was reached, the ones in it go right after these
+		std::size_t mErrorsBefore;
+		std::vector<Diagnostic> mErrors;
+
+		// the body is broken so the function is dropped (like parseFunction does)
+		bool mFailed;
+
+		// the body had more errors than the limit
+		bool mErrorsDropped;
+	};
+
+	// scanner that hands out the tokens to parse (batch or streamed)
+	Scanner& mScanner;
 
-	// current index into the scanner vector of tokens
-    int mTokenIndex;
+	// current token to be considered, points into the scanners ring so advancing never copies a token
+	Token * mCurrToken;
 
 	// stores error messages as parsing occurs and is used for outputting after
-    std::vector<std::shared_ptr<Error>> mErrors;
+    std::vector<Diagnostic> mErrors;
 
 	// name of the file we're parsing
 	const char * mFileName;
@@ -161,70 +255,176 @@ private:
 	// tracks the return type of the current function
 	Type mCurrReturnType;
 
+	// function whose body is being parsed, each call in it is added to its callees
+	ASTFunc * mCurrFunc;
+
     // track whether we need printf
 	bool mNeedPrintf;
 
+	// expression parser in use
+	ExprEngine mExprEngine;
+
+#ifdef CRISP_PARSE_STATS
+	// counters for the expression parser benchmark
+	std::size_t mExprCount;
+	std::size_t mExprCalls;
+#endif
+
+	// set when a syntax error is reported, from then on every parse function returns nullptr w/o consuming
+	// anything until the nearest recovery point resyncs and clears it
+	bool mPanic;
+
+	// offset of the token the last syntax error was reported at (or the one after a dropped invalid symbol),
+	// another error at the same token is a knock on effect so it is not reported
+	std::size_t mErrorAt;
+
+	// errors to stop the parse after, 0 for no limit
+	unsigned mErrorLimit;
+
+	// set once an error past the limit was dropped, only then is there a note that the rest was not looked at
+	bool mErrorsDropped;
+
+	// every AST node is allocated here and freed all at once w the parser
+	Arena mArena;
+
+	// nesting budget, each statement and expression inside another one is a level
+	unsigned mMaxDepth;
+	unsigned mDepth;
+
+	// blocks parseCompoundStmt has opened a block inside of, innermost last
+	std::vector<ASTCompoundStmt *> mOpenBlocks;
+
+	// functions declared so far, each ASTFunc is numbered w it
+	std::size_t mFuncCount;
+
+	// functions w a lower index can be called, a worker sees the ones up to the body it is parsing (as a serial
+	// parse would) while the main parser sees all of them
+	std::size_t mVisibleFuncs;
+
+	// number of threads the bodies are parsed on
+	unsigned mThreads;
+
+	// top level blocks from the pre-pass (empty when parsing serially) and the next one a function could start
+	std::vector<BodyRange> mBodies;
+	std::size_t mNextBody;
+
+	// bodies left for the workers in source order
+	std::vector<BodyJob> mJobs;
+
+	// symbol table views of the workers, they own the @@ idents their part of the AST points to
+	std::vector<std::unique_ptr<SymbolTable>> mViews;
+
+	// functions the compiled program starts from, empty to keep every function
+	std::vector<std::string> mRoots;
+
+	// the ones of mRoots no function is named after
+	std::vector<std::string> mMissingRoots;
+
 	// pointer to root node of our program
-	std::shared_ptr<ASTProg> mRoot;
+	ASTProg * mRoot;
     
-	// returns true if we are past last scanned token in vector
+	// a worker that parses function bodies for parent, reading its tokens w reader and looking up names in view
+	Parser(Parser& parent, Scanner& reader, SymbolTable& view) noexcept;
+
+	// parallel mode (in parseParallel.cpp)
+
+	// brace match the stored tokens into mBodies
+	void skimBodies() noexcept;
+
+	// the body from the pre-pass that starts at the current token (nullptr if it is not the { of one)
+	const BodyRange * bodyAt() noexcept;
+
+	// carry on from the } of range as if the body had been parsed
+	void skipBody(const BodyRange& range) noexcept;
+
+	// leave the body in range for a worker and skip past it
+	void deferBody(ASTFunc * func, const BodyRange& range) noexcept;
+
+	// parse every deferred body on mThreads threads and merge the results back in
+	void parseBodies();
+
+	// worker: parse the body of one function
+	void parseBody(BodyJob& job) noexcept;
+
+	// reachability mode (in parseLazy.cpp)
+
+	// clear mLive on the bodies in mBodies that no root calls into, going by the names in the tokens
+	void markLive();
+
+	// drop the functions the call graph does not reach from the roots out of mRoot
+	void dropUnreachable();
+
+	// returns true if we are past last scanned token
 	bool isAtEnd() const noexcept;
 
-	// advance to next token in vector
+	// advance to next token
 	void advance() noexcept;
 
-    // consumes the current token and throws an exception if next token is Unknown 
-	void consumeToken(bool unknownBad = true);
+	// token n past the current one w/o consuming anything (n < Scanner::Window, peek(0) is the current token)
+	const Token& peek(std::size_t n = 1) noexcept;
+
+    // consumes the current token, if unknownBad any Unknown tokens after it are reported and skipped
+	void consumeToken(bool unknownBad = true) noexcept;
 
     // sees if the token matches the requested
 	// if it does it will consume the token and return true otherwise it will return false
-	// throws an exception if next token is Unknown
 	bool peekAndConsume(TokenType desired) noexcept;
 
-    // returns true if the current token matches one of the tokens in the list.
-	bool peekIsOneOf(const std::vector<TokenType>& v) const noexcept;
+    // returns true if the current token is in the set (one AND, see tokenSet.h)
+	bool peekIsOneOf(TokenSet set) const noexcept {
+		return set.contains(mCurrToken->mType);
+	}
 
     // matches the current token against the requested token and consumes it
-	// throws an exception if there is a mismatch 
+	// reports a syntax error and returns false if there is a mismatch
 	// should only use this for terminals that are always a specific text
-	void matchToken(TokenType desired);
+	bool matchToken(TokenType desired) noexcept;
 
     // matches the current token against the first element
-	// in the vector and then consumes and verifies all
+	// in the sequence and then consumes and verifies all
 	// remaining requested elements
 	//
-	// throws an exception if there is a mismatch
-	// since it throws an exception it should only be used in instances where a
+	// reports a syntax error and returns false at the first mismatch
+	// so it should only be used in instances where a
 	// specific token order is the only valid match
-	// it also throws an exception if the next token is Unknown
-	void matchTokenSeq(const std::vector<TokenType>& v);
+	bool matchTokenSeq(std::initializer_list<TokenType> seq) noexcept;
 
 	// consumes tokens until either a match or EOF is found
 	void consumeUntil(TokenType desired) noexcept;
 
-	// consumes tokens until either a match of one in the vector or EOF is found
-	void consumeUntil(const std::vector<TokenType>& desired) noexcept;
+	// consumes tokens until either one in the set or EOF is found
+	void consumeUntil(TokenSet desired) noexcept;
+
+	// recovery point: skips to a token in sync and leaves panic mode
+	// returns false (still panicking) if the file runs out first
+	bool recover(TokenSet sync) noexcept;
+
+	// reports that the nesting budget ran out and skips what is nested at the current token
+	void tooDeep() noexcept;
 
 	// Gets the variable, if it exists. Otherwise
 	// reports a semant error and returns @@variable
-	Identifier * getVariable(const std::string& name) noexcept;
+	Identifier * getVariable(Atom name) noexcept;
 
 	// returns a char * that contains the type name
 	const char * getTypeText(Type type) const noexcept;
 
-    // helper functions to report syntax errors
-	void reportError(const ParseExcept& except) noexcept;
-
 	// helper functions to report syntax errors
 	void reportError(const std::string& msg) noexcept;
-	
-	// helper function to report semantic errors
-	void reportSemantError(const std::string& msg, int col = -1) noexcept;
 
-    // write an error message to the error stream
-	void displayErrorMsg(const std::string& line, std::shared_ptr<Error> error) noexcept;
+	// records an error unless there are mErrorLimit of them already, the first one past that ends the parse
+	void addError(const std::string& msg, std::int64_t line, std::int64_t col) noexcept;
+
+	// reports a syntax error and enters panic mode, nothing is reported if already panicking
+	void syntaxError(const std::string& msg) noexcept;
 	
-	// writes out all the error messages
+	// helper function to report semantic errors at the current token
+	void reportSemantError(const std::string& msg) noexcept;
+
+	// same but the column is taken from the token at offset (the line is still the current tokens)
+	void reportSemantError(const std::string& msg, std::size_t offset) noexcept;
+
+	// writes out all the error messages (see ../error/diagnostics.h)
 	void displayErrors() noexcept;
 };
 
@@ -1,23 +1,190 @@
-#include "../error/parseExcept.h"
+#include <array>
+#include <sstream>
+#include "../error/syntaxError.h"
 #include "astNodes.h"
 #include "parse.h"
 
-std::shared_ptr<ASTExpr> Parser::parseExpr() {
-	std::shared_ptr<ASTExpr> retVal = parseAssignExpr();
-	
+/*
+operator table for the Pratt parser (parseBinaryExpr), higher precedence binds tighter and every level groups to
+the left like the recursive descent chain below it. a new binary operator only needs an entry here (plus a case in
+parseBinaryExpr if it builds a new kind of node)
+*/
+
+namespace {
+	// which AST node an operator builds
+	enum class OpKind : std::uint8_t { None, Assign, Or, And, Cmp, Math };
+
+	struct BinaryOp {
+		std::uint8_t mPrec;
+		OpKind mKind;
+	};
+
+	constexpr std::size_t NumTokenTypes = static_cast<std::size_t>(TokenType::EndOfFile) + 1;
+
+	constexpr std::array<BinaryOp, NumTokenTypes> buildBinaryOps() noexcept {
+		std::array<BinaryOp, NumTokenTypes> ops {};
+
+		auto set = [&ops](TokenType type, std::uint8_t prec, OpKind kind) {
+			ops[static_cast<std::size_t>(type)] = {prec, kind};
+		};
+
+		set(TokenType::Assign, 1, OpKind::Assign);
+		set(TokenType::IncAssign, 1, OpKind::Assign);
+		set(TokenType::DecAssign, 1, OpKind::Assign);
+
+		set(TokenType::Or, 2, OpKind::Or);
+
+		set(TokenType::And, 3, OpKind::And);
+
+		set(TokenType::EqualTo, 4, OpKind::Cmp);
+		set(TokenType::NotEqual, 4, OpKind::Cmp);
+		set(TokenType::LessThan, 4, OpKind::Cmp);
+		set(TokenType::GreaterThan, 4, OpKind::Cmp);
+		set(TokenType::LThanOrEq, 4, OpKind::Cmp);
+		set(TokenType::GThanOrEq, 4, OpKind::Cmp);
+
+		set(TokenType::Plus, 5, OpKind::Math);
+		set(TokenType::Minus, 5, OpKind::Math);
+
+		set(TokenType::Mult, 6, OpKind::Math);
+		set(TokenType::Div, 6, OpKind::Math);
+		set(TokenType::Mod, 6, OpKind::Math);
+
+		return ops;
+	}
+
+	constexpr std::array<BinaryOp, NumTokenTypes> sBinaryOps = buildBinaryOps();
+
+	// lowest precedence in sBinaryOps i.e. a whole expression
+	constexpr int MinPrec = 1;
+
+	// hook up both operands of a binary node and work out its type
+	template <typename T>
+	bool finishOp(T * node, ASTExpr * lhs, ASTExpr * rhs) noexcept {
+		node->setLHS(lhs);
+		node->setRHS(rhs);
+
+		return node->finalizeOp();
+	}
+}
+
+ASTExpr * Parser::parseExpr() {
+	PARSE_STAT(mExprCount);
+
+	// ( Expr ), [ Expr ] and call arguments all come back through here so this is where expressions nest
+	if (mDepth == mMaxDepth) {
+		tooDeep();
+		return nullptr;
+	}
+
+	++mDepth;
+
 	// if retVal is null we did not get a lhs and this is not an expr
+	ASTExpr * retVal = mExprEngine == ExprEngine::Pratt ? parseBinaryExpr(MinPrec) : parseAssignExpr();
+
+	--mDepth;
+
 	return retVal;
 }
 
-std::shared_ptr<ASTExpr> Parser::parseAssignExpr() {
-	std::shared_ptr<ASTExpr> retVal;
-	std::shared_ptr<ASTAssignOp> prime;
+// precedence climbing: parse a value then keep folding in operators that bind at least as tight as minPrec,
+// the rhs of each is parsed one level up so operators of the same precedence group to the left
+ASTExpr * Parser::parseBinaryExpr(int minPrec) {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * lhs = parseValue();
 
-	std::shared_ptr<ASTExpr> v = parseOrTerm();
+	if (!lhs) return nullptr;
+
+	for (;;) {
+		BinaryOp op = sBinaryOps[static_cast<std::size_t>(mCurrToken->mType)];
+
+		if (op.mKind == OpKind::None || op.mPrec < minPrec) break;
+
+		// lhs must be an ident or ident array 
+		if (op.mKind == OpKind::Assign && !isa<ASTArrayExpr>(lhs) && !isa<ASTIdentExpr>(lhs)) {
+			syntaxError("L-value required as left operand of assignment");
+			return nullptr;
+		}
+
+		TokenType token = mCurrToken->mType;
+		std::size_t offset = mCurrToken->mOffset;
+
+		consumeToken();
+
+		ASTExpr * rhs = parseBinaryExpr(op.mPrec + 1);
+
+		if (!rhs) {
+			syntaxError(SyntaxError::operandMissing(token));
+			return nullptr;
+		}
+
+		ASTExpr * node = nullptr;
+		bool valid = false;
+
+		switch (op.mKind) {
+			case OpKind::Assign: {
+				ASTAssignOp * assign = mArena.make<ASTAssignOp>(token);
+				valid = finishOp(assign, lhs, rhs);
+				node = assign;
+				break;
+			}
+			case OpKind::Or: {
+				ASTLogicalOr * logicalOr = mArena.make<ASTLogicalOr>();
+				valid = finishOp(logicalOr, lhs, rhs);
+				node = logicalOr;
+				break;
+			}
+			case OpKind::And: {
+				ASTLogicalAnd * logicalAnd = mArena.make<ASTLogicalAnd>();
+				valid = finishOp(logicalAnd, lhs, rhs);
+				node = logicalAnd;
+				break;
+			}
+			case OpKind::Cmp: {
+				ASTBinaryCmpOp * cmp = mArena.make<ASTBinaryCmpOp>(token);
+				valid = finishOp(cmp, lhs, rhs);
+				node = cmp;
+				break;
+			}
+			case OpKind::Math: {
+				ASTBinaryMathOp * math = mArena.make<ASTBinaryMathOp>(token);
+				valid = finishOp(math, lhs, rhs);
+				node = math;
+				break;
+			}
+			case OpKind::None:
+				break;
+		}
+
+		if (!valid) {
+			std::string err("Cannot perform op between type ");
+			err += getTypeText(lhs->getType());
+			err += " and ";
+			err += getTypeText(rhs->getType());
+
+			reportSemantError(err, offset);
+		}
+
+		lhs = node;
+	}
+
+	return lhs;
+}
+
+ASTExpr * Parser::parseAssignExpr() {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * retVal = nullptr;
+	ASTAssignOp * prime = nullptr;
+
+	ASTExpr * v = parseOrTerm();
 	if (v) {
 		retVal = v;
 		
         prime = parseAssignExprPrime(v);
+
+		if (mPanic) return nullptr;
 		
         if (prime) retVal = prime;
 	}
@@ -25,25 +192,24 @@ std::shared_ptr<ASTExpr> Parser::parseAssignExpr() {
 	return retVal;
 }
 
-std::shared_ptr<ASTAssignOp> Parser::parseAssignExprPrime(std::shared_ptr<ASTExpr> lhs) {
-	std::shared_ptr<ASTAssignOp> retVal;
-	std::shared_ptr<ASTAssignOp> recursion;
-	std::shared_ptr<ASTExpr> rhs;
+ASTAssignOp * Parser::parseAssignExprPrime(ASTExpr * lhs) {
+	PARSE_STAT(mExprCalls);
+
+	ASTAssignOp * retVal = nullptr;
+	ASTExpr * rhs = nullptr;
 	
-	if (peekIsOneOf({TokenType::Assign, TokenType::DecAssign, TokenType::IncAssign})) {
+	while (peekIsOneOf(Grammar::AssignOps)) {
 		// lhs must be an ident or ident array 
-		std::shared_ptr<ASTArrayExpr> arrExpr = std::dynamic_pointer_cast<ASTArrayExpr>(lhs);
-		std::shared_ptr<ASTIdentExpr> identExpr = std::dynamic_pointer_cast<ASTIdentExpr>(lhs);
-
-		if (!arrExpr && !identExpr) {
-			throw ParseExceptMsg("L-value required as left operand of assignment");
+		if (!isa<ASTArrayExpr>(lhs) && !isa<ASTIdentExpr>(lhs)) {
+			syntaxError("L-value required as left operand of assignment");
+			return nullptr;
 		}
 
-		TokenType token = mCurrToken.mType;
+		TokenType token = mCurrToken->mType;
 
-		retVal = std::make_shared<ASTAssignOp>(mCurrToken.mType);
+		retVal = mArena.make<ASTAssignOp>(mCurrToken->mType);
 				
-		int col = mCurrToken.mCol;
+		std::size_t offset = mCurrToken->mOffset;
 
 		consumeToken();
 
@@ -51,7 +217,10 @@ std::shared_ptr<ASTAssignOp> Parser::parseAssignExprPrime(std::shared_ptr<ASTExp
 
 		rhs = parseOrTerm();
 
-		if (!rhs) throw OperandMissing(token);
+		if (!rhs) {
+			syntaxError(SyntaxError::operandMissing(token));
+			return nullptr;
+		}
 
 		retVal->setRHS(rhs);
 
@@ -61,26 +230,28 @@ std::shared_ptr<ASTAssignOp> Parser::parseAssignExprPrime(std::shared_ptr<ASTExp
 			err += " and ";
 			err += getTypeText(rhs->getType());
 
-			reportSemantError(err, col);
+			reportSemantError(err, offset);
 		}
 
-		recursion = parseAssignExprPrime(retVal);
-
-		if (recursion) retVal = recursion;
+		lhs = retVal;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTExpr> Parser::parseOrTerm() {
-	std::shared_ptr<ASTExpr> retVal;
-	std::shared_ptr<ASTLogicalOr> prime;
+ASTExpr * Parser::parseOrTerm() {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * retVal = nullptr;
+	ASTLogicalOr * prime = nullptr;
 
 	// this should not directly check factor but instead implement the proper grammar rule
-	std::shared_ptr<ASTExpr> v = parseAndTerm();
+	ASTExpr * v = parseAndTerm();
 	if (v) {
 		retVal = v;
 		prime = parseOrTermPrime(v);
+
+		if (mPanic) return nullptr;
 		
         if (prime) retVal = prime;
 	}
@@ -88,23 +259,27 @@ std::shared_ptr<ASTExpr> Parser::parseOrTerm() {
 	return retVal;
 }
 
-std::shared_ptr<ASTLogicalOr> Parser::parseOrTermPrime(std::shared_ptr<ASTExpr> lhs) {
-	std::shared_ptr<ASTLogicalOr> retVal;
-	std::shared_ptr<ASTLogicalOr> recursion;
-	std::shared_ptr<ASTExpr> rhs;
+ASTLogicalOr * Parser::parseOrTermPrime(ASTExpr * lhs) {
+	PARSE_STAT(mExprCalls);
+
+	ASTLogicalOr * retVal = nullptr;
+	ASTExpr * rhs = nullptr;
 
-	if (mCurrToken.mType == TokenType::Or) {
-		retVal = std::make_shared<ASTLogicalOr>();
+	while (mCurrToken->mType == TokenType::Or) {
+		retVal = mArena.make<ASTLogicalOr>();
 
 		retVal->setLHS(lhs);
 
-		int col = mCurrToken.mCol;
+		std::size_t offset = mCurrToken->mOffset;
 
 		consumeToken();
 
 		rhs = parseAndTerm();
 
-		if (!rhs) throw OperandMissing(TokenType::Or);
+		if (!rhs) {
+			syntaxError(SyntaxError::operandMissing(TokenType::Or));
+			return nullptr;
+		}
 		
         retVal->setRHS(rhs);
 
@@ -114,26 +289,28 @@ std::shared_ptr<ASTLogicalOr> Parser::parseOrTermPrime(std::shared_ptr<ASTExpr>
 			err += " and ";
 			err += getTypeText(rhs->getType());
 
-			reportSemantError(err, col);
+			reportSemantError(err, offset);
 		}
 
-		recursion = parseOrTermPrime(retVal);
-
-		if (recursion) retVal = recursion;
+		lhs = retVal;
 	}
 
 	return retVal;
 }
 
-std::shared_ptr<ASTExpr> Parser::parseAndTerm() {
-	std::shared_ptr<ASTExpr> retVal;
-	std::shared_ptr<ASTLogicalAnd> prime;
+ASTExpr * Parser::parseAndTerm() {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * retVal = nullptr;
+	ASTLogicalAnd * prime = nullptr;
 
 	// this should not directly check factor but instead implement the proper grammar rule
-	std::shared_ptr<ASTExpr> v = parseRelExpr();
+	ASTExpr * v = parseRelExpr();
 	if (v) {
 		retVal = v;
 		prime = parseAndTermPrime(v);
+
+		if (mPanic) return nullptr;
 		
         if (prime) retVal = prime;
 	}
@@ -141,23 +318,27 @@ std::shared_ptr<ASTExpr> Parser::parseAndTerm() {
 	return retVal;
 }
 
-std::shared_ptr<ASTLogicalAnd> Parser::parseAndTermPrime(std::shared_ptr<ASTExpr> lhs) {
-	std::shared_ptr<ASTLogicalAnd> retVal;
-	std::shared_ptr<ASTLogicalAnd> recursion;
-	std::shared_ptr<ASTExpr> rhs;
+ASTLogicalAnd * Parser::parseAndTermPrime(ASTExpr * lhs) {
+	PARSE_STAT(mExprCalls);
 
-	if (mCurrToken.mType == TokenType::And) {
-		retVal = std::make_shared<ASTLogicalAnd>();
+	ASTLogicalAnd * retVal = nullptr;
+	ASTExpr * rhs = nullptr;
+
+	while (mCurrToken->mType == TokenType::And) {
+		retVal = mArena.make<ASTLogicalAnd>();
 
 		retVal->setLHS(lhs);
 
-		int col = mCurrToken.mCol;
+		std::size_t offset = mCurrToken->mOffset;
 
 		consumeToken();
 
 		rhs = parseRelExpr();
 
-		if (!rhs) throw OperandMissing(TokenType::And);
+		if (!rhs) {
+			syntaxError(SyntaxError::operandMissing(TokenType::And));
+			return nullptr;
+		}
 		
         retVal->setRHS(rhs);
 
@@ -167,44 +348,47 @@ std::shared_ptr<ASTLogicalAnd> Parser::parseAndTermPrime(std::shared_ptr<ASTExpr
 			err += " and ";
 			err += getTypeText(rhs->getType());
 
-			reportSemantError(err, col);
+			reportSemantError(err, offset);
 		}
 
-		recursion = parseAndTermPrime(retVal);
-
-		if (recursion) retVal = recursion;
+		lhs = retVal;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTExpr> Parser::parseRelExpr() {
-	std::shared_ptr<ASTExpr> retVal;
-	std::shared_ptr<ASTBinaryCmpOp> prime;
+ASTExpr * Parser::parseRelExpr() {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * retVal = nullptr;
+	ASTBinaryCmpOp * prime = nullptr;
 
-	std::shared_ptr<ASTExpr> v = parseNumExpr();
+	ASTExpr * v = parseNumExpr();
 	if (v) {
 		retVal = v;
 
 		prime = parseRelExprPrime(v);
 
+		if (mPanic) return nullptr;
+
 		if (prime) retVal = prime;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTBinaryCmpOp> Parser::parseRelExprPrime(std::shared_ptr<ASTExpr> lhs) {
-	std::shared_ptr<ASTBinaryCmpOp> retVal;
-	std::shared_ptr<ASTBinaryCmpOp> recursion;
-	std::shared_ptr<ASTExpr> rhs;
+ASTBinaryCmpOp * Parser::parseRelExprPrime(ASTExpr * lhs) {
+	PARSE_STAT(mExprCalls);
+
+	ASTBinaryCmpOp * retVal = nullptr;
+	ASTExpr * rhs = nullptr;
 	
-	if (peekIsOneOf({TokenType::EqualTo, TokenType::NotEqual, TokenType::LessThan, TokenType::GreaterThan, TokenType::LThanOrEq, TokenType::GThanOrEq})) {
-		TokenType token = mCurrToken.mType;
+	while (peekIsOneOf(Grammar::RelOps)) {
+		TokenType token = mCurrToken->mType;
 
-		retVal = std::make_shared<ASTBinaryCmpOp>(token);
+		retVal = mArena.make<ASTBinaryCmpOp>(token);
 
-		int col = mCurrToken.mCol;
+		std::size_t offset = mCurrToken->mOffset;
 
 		consumeToken();
 
@@ -212,7 +396,10 @@ std::shared_ptr<ASTBinaryCmpOp> Parser::parseRelExprPrime(std::shared_ptr<ASTExp
 
 		rhs = parseNumExpr();
 
-		if (!rhs) throw OperandMissing(token);
+		if (!rhs) {
+			syntaxError(SyntaxError::operandMissing(token));
+			return nullptr;
+		}
 
 		retVal->setRHS(rhs);
 
@@ -222,26 +409,28 @@ std::shared_ptr<ASTBinaryCmpOp> Parser::parseRelExprPrime(std::shared_ptr<ASTExp
 			err += " and ";
 			err += getTypeText(rhs->getType());
 
-			reportSemantError(err, col);
+			reportSemantError(err, offset);
 		}
 
-		recursion = parseRelExprPrime(retVal);
-
-		if (recursion) retVal = recursion;
+		lhs = retVal;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTExpr> Parser::parseNumExpr() {
-	std::shared_ptr<ASTExpr> retVal;
-	std::shared_ptr<ASTBinaryMathOp> prime;
+ASTExpr * Parser::parseNumExpr() {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * retVal = nullptr;
+	ASTBinaryMathOp * prime = nullptr;
 	
-	std::shared_ptr<ASTExpr> v = parseTerm();
+	ASTExpr * v = parseTerm();
 	if (v) {
 		retVal = v;
 		
         prime = parseNumExprPrime(v);
+
+		if (mPanic) return nullptr;
 		
         if (prime) retVal = prime;
 	}
@@ -249,17 +438,18 @@ std::shared_ptr<ASTExpr> Parser::parseNumExpr() {
 	return retVal;
 }
 
-std::shared_ptr<ASTBinaryMathOp> Parser::parseNumExprPrime(std::shared_ptr<ASTExpr> lhs) {
-	std::shared_ptr<ASTBinaryMathOp> retVal;
-	std::shared_ptr<ASTBinaryMathOp> recursion;
-	std::shared_ptr<ASTExpr> rhs;
+ASTBinaryMathOp * Parser::parseNumExprPrime(ASTExpr * lhs) {
+	PARSE_STAT(mExprCalls);
 
-	if (peekIsOneOf({TokenType::Plus, TokenType::Minus})) {
-        TokenType token = mCurrToken.mType;
+	ASTBinaryMathOp * retVal = nullptr;
+	ASTExpr * rhs = nullptr;
 
-		retVal = std::make_shared<ASTBinaryMathOp>(token);
+	while (peekIsOneOf(Grammar::AddOps)) {
+        TokenType token = mCurrToken->mType;
 
-		int col = mCurrToken.mCol;
+		retVal = mArena.make<ASTBinaryMathOp>(token);
+
+		std::size_t offset = mCurrToken->mOffset;
 
 		consumeToken();
 
@@ -267,7 +457,10 @@ std::shared_ptr<ASTBinaryMathOp> Parser::parseNumExprPrime(std::shared_ptr<ASTEx
 
 		rhs = parseTerm();
 
-		if (!rhs) throw OperandMissing(token);
+		if (!rhs) {
+			syntaxError(SyntaxError::operandMissing(token));
+			return nullptr;
+		}
 		
         retVal->setRHS(rhs);
 
@@ -277,45 +470,48 @@ std::shared_ptr<ASTBinaryMathOp> Parser::parseNumExprPrime(std::shared_ptr<ASTEx
 			err += " and ";
 			err += getTypeText(rhs->getType());
 
-			reportSemantError(err, col);
+			reportSemantError(err, offset);
 		}
 
-		recursion = parseNumExprPrime(retVal);
-
-		if (recursion) retVal = recursion;
+		lhs = retVal;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTExpr> Parser::parseTerm() {
-	std::shared_ptr<ASTExpr> retVal;
-	std::shared_ptr<ASTBinaryMathOp> prime;
+ASTExpr * Parser::parseTerm() {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * retVal = nullptr;
+	ASTBinaryMathOp * prime = nullptr;
 
 	
-	std::shared_ptr<ASTExpr> v = parseValue();
+	ASTExpr * v = parseValue();
 	if (v) {
 		retVal = v;
 
 		prime = parseTermPrime(v);
 
+		if (mPanic) return nullptr;
+
 		if (prime) retVal = prime;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTBinaryMathOp> Parser::parseTermPrime(std::shared_ptr<ASTExpr> lhs) {
-	std::shared_ptr<ASTBinaryMathOp> retVal;
-	std::shared_ptr<ASTBinaryMathOp> recursion;
-	std::shared_ptr<ASTExpr> rhs;
+ASTBinaryMathOp * Parser::parseTermPrime(ASTExpr * lhs) {
+	PARSE_STAT(mExprCalls);
+
+	ASTBinaryMathOp * retVal = nullptr;
+	ASTExpr * rhs = nullptr;
 
-	if (peekIsOneOf({TokenType::Mult, TokenType::Div, TokenType::Mod})) {
-		TokenType token = mCurrToken.mType;
+	while (peekIsOneOf(Grammar::MulOps)) {
+		TokenType token = mCurrToken->mType;
 
-		retVal = std::make_shared<ASTBinaryMathOp>(token);
+		retVal = mArena.make<ASTBinaryMathOp>(token);
 
-		int col = mCurrToken.mCol;
+		std::size_t offset = mCurrToken->mOffset;
 
 		consumeToken();
 
@@ -323,7 +519,10 @@ std::shared_ptr<ASTBinaryMathOp> Parser::parseTermPrime(std::shared_ptr<ASTExpr>
 
 		rhs = parseValue();
 		
-        if (!rhs) throw OperandMissing(token);
+        if (!rhs) {
+			syntaxError(SyntaxError::operandMissing(token));
+			return nullptr;
+		}
 		
         retVal->setRHS(rhs);
 
@@ -333,25 +532,25 @@ std::shared_ptr<ASTBinaryMathOp> Parser::parseTermPrime(std::shared_ptr<ASTExpr>
 			err += " and ";
 			err += getTypeText(rhs->getType());
 
-			reportSemantError(err, col);
+			reportSemantError(err, offset);
 		}
 		
-		recursion = parseTermPrime(retVal);
-
-		if (recursion) retVal = recursion;
+		lhs = retVal;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTExpr> Parser::parseValue() {
-	std::shared_ptr<ASTExpr> retVal;
+ASTExpr * Parser::parseValue() {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * retVal = nullptr;
 	
 	if (peekAndConsume(TokenType::Not)) {
-		std::shared_ptr<ASTExpr> f = parseFactor();
+		ASTExpr * f = parseFactor();
 
-		if (f) retVal = std::make_shared<ASTNotExpr>(f);
-		else throw ParseExceptMsg("! must be followed by an expression.");
+		if (f) retVal = mArena.make<ASTNotExpr>(f);
+		else syntaxError("! must be followed by an expression.");
 	} else {
        retVal = parseFactor(); 
     }
@@ -360,32 +559,38 @@ std::shared_ptr<ASTExpr> Parser::parseValue() {
 }
 
 
-std::shared_ptr<ASTExpr> Parser::parseFactor() {
-	std::shared_ptr<ASTExpr> retVal;
+ASTExpr * Parser::parseFactor() {
+	PARSE_STAT(mExprCalls);
+
+	ASTExpr * retVal = nullptr;
 	
-	if ((retVal = parseParenFactor()));
+	// the first one to hit a syntax error stops the rest from being tried
+	if ((retVal = parseParenFactor()) || mPanic);
 	else if ((retVal = parseConstantFactor()));
 	else if ((retVal = parseStringFactor()));
-	else if ((retVal = parseCharFactor()));
+	else if ((retVal = parseCharFactor()) || mPanic);
 	else if ((retVal = parseDoubleFactor()));
-	else if ((retVal = parseIdentFactor()));
-	else if ((retVal = parseIncFactor()));
-	else if ((retVal = parseDecFactor()));
+	else if ((retVal = parseIdentFactor()) || mPanic);
+	else if ((retVal = parseIncFactor()) || mPanic);
+	else if ((retVal = parseDecFactor()) || mPanic);
 	else if ((retVal = parseAddrOfArrayFactor()));
 	
 	return retVal;
 }
 
 // ( Expr )
-std::shared_ptr<ASTExpr> Parser::parseParenFactor() {
-	std::shared_ptr<ASTExpr> retVal;
+ASTExpr * Parser::parseParenFactor() {
+	ASTExpr * retVal = nullptr;
 
 	if (peekAndConsume(TokenType::LParen)) {
 		retVal = parseExpr();
 		
-        if (!retVal) throw ParseExceptMsg("Not a valid expression inside parenthesis");
+        if (!retVal) {
+			syntaxError("Not a valid expression inside parenthesis");
+			return nullptr;
+		}
 		
-        matchToken(TokenType::RParen);
+        if (!matchToken(TokenType::RParen)) return nullptr;
 	}
 	
 	return retVal;
@@ -396,13 +601,13 @@ std::shared_ptr<ASTExpr> Parser::parseParenFactor() {
 // id ( FuncCallArgs )
 // id [Expr] (+=, -=, =) Expr
 // id (+=, -=, =) Expr
-std::shared_ptr<ASTExpr> Parser::parseIdentFactor() {
-	std::shared_ptr<ASTExpr> retVal;
+ASTExpr * Parser::parseIdentFactor() {
+	ASTExpr * retVal = nullptr;
 
-	if (mCurrToken.mType == TokenType::Identifier) {
-		Identifier * ident = getVariable(mCurrToken.mStr);
+	if (mCurrToken->mType == TokenType::Identifier) {
+		Identifier * ident = getVariable(mCurrToken->mAtom);
 		
-		int col = mCurrToken.mCol; 
+		std::size_t offset = mCurrToken->mOffset; 
 
 		consumeToken();
 
@@ -410,32 +615,30 @@ std::shared_ptr<ASTExpr> Parser::parseIdentFactor() {
 			if (ident->getType() != Type::DoubleArray && ident->getType() != Type::IntArray && ident->getType() != Type::CharArray && !ident->isDummy()) {
 				std::string err("Identifier is not an array");
 
-				reportSemantError(err, col);
+				reportSemantError(err, offset);
 				
-				consumeUntil(TokenType::RBracket);
+				// skip to the closing ] but not past the end of the statement
+				consumeUntil(TokenSet {TokenType::RBracket, TokenType::SemiColon, TokenType::LBrace, TokenType::RBrace});
 
-				if (mCurrToken.mType == TokenType::EndOfFile) throw EOFExcept();
-
-				matchToken(TokenType::RBracket);
+				if (!matchToken(TokenType::RBracket)) return nullptr;
 				
 				// return error variable
-				retVal = std::make_shared<ASTIdentExpr>(*mSymbolTable.getIdentifier("@@variable"));
+				retVal = mArena.make<ASTIdentExpr>(*mSymbolTable.getIdentifier(Atoms::Variable));
 			} else {
-				try {
-					std::shared_ptr<ASTExpr> expr = parseExpr();
-					
-					if (!expr) throw ParseExceptMsg("Valid expression required inside [ ].");
-					
-					retVal = std::make_shared<ASTArrayExpr>(*ident, expr);
-				} catch (ParseExcept& e) {
-					reportError(e);
-
-					consumeUntil(TokenType::RBracket);
+				ASTExpr * expr = parseExpr();
+				
+				if (!expr) syntaxError("Valid expression required inside [ ].");
+				
+				if (mPanic) {
+					// resync on the ] and carry on w the error variable
+					if (!recover(TokenSet {TokenType::RBracket})) return nullptr;
 
-					if (mCurrToken.mType == TokenType::EndOfFile) throw EOFExcept();
+					retVal = mArena.make<ASTIdentExpr>(*mSymbolTable.getIdentifier(Atoms::Variable));
+				} else {
+					retVal = mArena.make<ASTArrayExpr>(*ident, expr);
 				}
 				
-				matchToken(TokenType::RBracket);	
+				if (!matchToken(TokenType::RBracket)) return nullptr;
 			}
 		} else if (peekAndConsume(TokenType::LParen)) {
 			// check to make sure this is a function
@@ -446,82 +649,79 @@ std::shared_ptr<ASTExpr> Parser::parseIdentFactor() {
 
 				reportSemantError(err);
 
-				consumeUntil(TokenType::RParen);
+				// skip to the closing ) but not past the end of the statement
+				consumeUntil(TokenSet {TokenType::RParen, TokenType::SemiColon, TokenType::LBrace, TokenType::RBrace});
 
-				if (mCurrToken.mType == TokenType::EndOfFile) throw EOFExcept();
-				
-				matchToken(TokenType::RParen);
+				if (!matchToken(TokenType::RParen)) return nullptr;
 				
 				// just return our error variable
-				retVal = std::make_shared<ASTIdentExpr>(*mSymbolTable.getIdentifier("@@variable"));
+				retVal = mArena.make<ASTIdentExpr>(*mSymbolTable.getIdentifier(Atoms::Variable));
 			} else {				
 				// a function call can have zero or more arguments
-				std::shared_ptr<ASTFuncExpr> funcCall = std::make_shared<ASTFuncExpr>(*ident);
+				ASTFuncExpr * funcCall = mArena.make<ASTFuncExpr>(*ident);
 				retVal = funcCall;
 				
 				// get the number of arguments for this function
-				std::shared_ptr<ASTFunc> func = ident->getFunction();
-				try {
-					int currArg = 1, col = mCurrToken.mCol;
-
-					std::shared_ptr<ASTExpr> arg = parseExpr();
-
-					while (arg) {
-						// check for validity of this argument (for non-dummy functions)
-						if (!ident->isDummy()) {
-							// special case for "printf" since we dont make a node for it
-							if (ident->getName() == "printf") {
-								mNeedPrintf = true;
-
-								if (currArg == 1 && arg->getType() != Type::CharArray) {
-									reportSemantError("The first parameter to printf must be a char[]");
-								}
-							} else if (currArg > func->getNumArgs()) {
-									std::string err("Function ");
-									err += ident->getName();
-									err += " takes only ";
-
-									std::ostringstream ss;
-									ss << func->getNumArgs();
-									err += ss.str();
-									err += " arguments";
-
-									reportSemantError(err, col);
-							} else if (!func->checkArgType(currArg, arg->getType())) {
-								// no conversions at the moment
-								std::string err("Expected expression of type ");
-								err += getTypeText(func->getArgType(currArg));
-
-								reportSemantError(err, col);
-							}
-						}
-						
-						funcCall->addArg(arg);
-					
-						currArg++;
-						
-						if (peekAndConsume(TokenType::Comma)) {
-							col = mCurrToken.mCol;
+				ASTFunc * func = ident->getFunction();
+				int currArg = 1;
+
+				if (func && mCurrFunc) mCurrFunc->addCallee(mArena, func);
+				std::size_t offset = mCurrToken->mOffset;
+
+				ASTExpr * arg = parseExpr();
 
-							arg = parseExpr();
+				while (arg) {
+					// check for validity of this argument (for non-dummy functions)
+					if (!ident->isDummy()) {
+						// special case for "printf" since we dont make a node for it
+						if (ident->getAtom() == Atoms::Printf) {
+							mNeedPrintf = true;
 
-							if (!arg) throw ParseExceptMsg("Comma must be followed by expression in function call");
-						} else {
-							break;
+							if (currArg == 1 && arg->getType() != Type::CharArray) {
+								reportSemantError("The first parameter to printf must be a char[]");
+							}
+						} else if (currArg > func->getNumArgs()) {
+								std::string err("Function ");
+								err += ident->getName();
+								err += " takes only ";
+
+								std::ostringstream ss;
+								ss << func->getNumArgs();
+								err += ss.str();
+								err += " arguments";
+
+								reportSemantError(err, offset);
+						} else if (!func->checkArgType(currArg, arg->getType())) {
+							// no conversions at the moment
+							std::string err("Expected expression of type ");
+							err += getTypeText(func->getArgType(currArg));
+
+							reportSemantError(err, offset);
 						}
 					}
-				} catch (ParseExcept& e) {
-					reportError(e);
+					
+					funcCall->addArg(mArena, arg);
+				
+					currArg++;
+					
+					if (peekAndConsume(TokenType::Comma)) {
+						offset = mCurrToken->mOffset;
 
-					consumeUntil(TokenType::RParen);
+						arg = parseExpr();
 
-					if (mCurrToken.mType == TokenType::EndOfFile) throw EOFExcept();
+						if (!arg) syntaxError("Comma must be followed by expression in function call");
+					} else {
+						break;
+					}
 				}
+
+				// resync on the end of the call
+				if (mPanic && !recover(TokenSet {TokenType::RParen})) return nullptr;
 				
 				// now make sure we have the correct number of arguments
 				if (!ident->isDummy()) {
 					// special case for printf
-					if (ident->getName() == "printf") {
+					if (ident->getAtom() == Atoms::Printf) {
 						if (funcCall->getNumArgs() == 0) {
 							reportSemantError("printf requires a minimum of one argument");
 						}
@@ -540,11 +740,11 @@ std::shared_ptr<ASTExpr> Parser::parseIdentFactor() {
 					}
 				}
 				
-				matchToken(TokenType::RParen);
+				if (!matchToken(TokenType::RParen)) return nullptr;
 			}
 		} else {
 			// just a plain old ident
-			retVal = std::make_shared<ASTIdentExpr>(*ident);
+			retVal = mArena.make<ASTIdentExpr>(*ident);
 		}
 	}
 
@@ -552,11 +752,19 @@ std::shared_ptr<ASTExpr> Parser::parseIdentFactor() {
 }
 
 // constant
-std::shared_ptr<ASTConstantExpr> Parser::parseConstantFactor() {
-	std::shared_ptr<ASTConstantExpr> retVal;
+ASTConstantExpr * Parser::parseConstantFactor() {
+	ASTConstantExpr * retVal = nullptr;
 	
-	if (peekIsOneOf({TokenType::IntLit})) {
-		retVal = std::make_shared<ASTConstantExpr>(mCurrToken.mStr);
+	if (mCurrToken->mType == TokenType::IntLit) {
+		if (!mCurrToken->mNumber.mInRange) {
+			std::string err("Integer literal '");
+			err += mCurrToken->mStr;
+			err += "' is out of range for type int";
+
+			reportSemantError(err);
+		}
+
+		retVal = mArena.make<ASTConstantExpr>(mCurrToken->mNumber.mInt);
 		consumeToken();
 	}
 
@@ -564,11 +772,11 @@ std::shared_ptr<ASTConstantExpr> Parser::parseConstantFactor() {
 }
 
 // string
-std::shared_ptr<ASTStringExpr> Parser::parseStringFactor() {
-	std::shared_ptr<ASTStringExpr> retVal;
+ASTStringExpr * Parser::parseStringFactor() {
+	ASTStringExpr * retVal = nullptr;
 
-	if (peekIsOneOf({TokenType::StringLit})) {
-		retVal = std::make_shared<ASTStringExpr>(mCurrToken.mStr, mStringTable);
+	if (mCurrToken->mType == TokenType::StringLit) {
+		retVal = mArena.make<ASTStringExpr>(mCurrToken->mStr, mCurrToken->mOffset, mStringTable);
 		consumeToken();
 	}
 
@@ -576,13 +784,16 @@ std::shared_ptr<ASTStringExpr> Parser::parseStringFactor() {
 }
 
 // char
-std::shared_ptr<ASTCharExpr> Parser::parseCharFactor() {
-	std::shared_ptr<ASTCharExpr> retVal;
+ASTCharExpr * Parser::parseCharFactor() {
+	ASTCharExpr * retVal = nullptr;
 
-	if (peekIsOneOf({TokenType::CharLit})) {
-		if (mCurrToken.mStr.size() > 1) throw ParseExceptMsg("Size of char should not be greater than 1");
+	if (mCurrToken->mType == TokenType::CharLit) {
+		if (mCurrToken->mStr.size() > 1) {
+			syntaxError("Size of char should not be greater than 1");
+			return nullptr;
+		}
 
-		retVal = std::make_shared<ASTCharExpr>(mCurrToken.mStr);
+		retVal = mArena.make<ASTCharExpr>(mCurrToken->mStr);
 		consumeToken();
 	}
 
@@ -590,11 +801,19 @@ std::shared_ptr<ASTCharExpr> Parser::parseCharFactor() {
 }
 
 // double
-std::shared_ptr<ASTDoubleExpr> Parser::parseDoubleFactor() {
-	std::shared_ptr<ASTDoubleExpr> retVal;
+ASTDoubleExpr * Parser::parseDoubleFactor() {
+	ASTDoubleExpr * retVal = nullptr;
 
-	if (peekIsOneOf({TokenType::DoubleLit})) {
-		retVal = std::make_shared<ASTDoubleExpr>(mCurrToken.mStr);
+	if (mCurrToken->mType == TokenType::DoubleLit) {
+		if (!mCurrToken->mNumber.mInRange) {
+			std::string err("Double literal '");
+			err += mCurrToken->mStr;
+			err += "' is out of range for type double";
+
+			reportSemantError(err);
+		}
+
+		retVal = mArena.make<ASTDoubleExpr>(mCurrToken->mNumber.mDouble);
 		consumeToken();
 	}
 
@@ -602,63 +821,81 @@ std::shared_ptr<ASTDoubleExpr> Parser::parseDoubleFactor() {
 }
 
 // ++id
-std::shared_ptr<ASTExpr> Parser::parseIncFactor() {
-	std::shared_ptr<ASTExpr> retVal;
+ASTExpr * Parser::parseIncFactor() {
+	ASTExpr * retVal = nullptr;
 	
 	if (peekAndConsume(TokenType::Inc)) {
-		if (!peekIsOneOf({TokenType::Identifier})) throw ParseExceptMsg("++ must be followed by an identifier.");
+		if (mCurrToken->mType != TokenType::Identifier) {
+			syntaxError("++ must be followed by an identifier.");
+			return nullptr;
+		}
 
-		Identifier * ident = getVariable(mCurrToken.mStr);
+		Identifier * ident = getVariable(mCurrToken->mAtom);
 
-		std::shared_ptr<ASTExpr> expr = parseExpr();
+		ASTExpr * expr = parseExpr();
 
-		if (!expr) throw ParseExceptMsg("++ followed by invalid expression.");
+		if (!expr) {
+			syntaxError("++ followed by invalid expression.");
+			return nullptr;
+		}
 
-		retVal = std::make_shared<ASTIncExpr>(*ident, expr);
+		retVal = mArena.make<ASTIncExpr>(*ident, expr);
 	}
 	
 	return retVal;
 }
 
 // --id
-std::shared_ptr<ASTExpr> Parser::parseDecFactor() {
-	std::shared_ptr<ASTExpr> retVal;
+ASTExpr * Parser::parseDecFactor() {
+	ASTExpr * retVal = nullptr;
 
 	if (peekAndConsume(TokenType::Dec)) {
-		if (!peekIsOneOf({TokenType::Identifier})) throw ParseExceptMsg("-- must be followed by an identifier.");
+		if (mCurrToken->mType != TokenType::Identifier) {
+			syntaxError("-- must be followed by an identifier.");
+			return nullptr;
+		}
 
-		Identifier * ident = getVariable(mCurrToken.mStr);
+		Identifier * ident = getVariable(mCurrToken->mAtom);
 
-		std::shared_ptr<ASTExpr> expr = parseExpr();
+		ASTExpr * expr = parseExpr();
 
-		if (!expr) throw ParseExceptMsg("-- followed by invalid expression.");
+		if (!expr) {
+			syntaxError("-- followed by invalid expression.");
+			return nullptr;
+		}
 
-		retVal = std::make_shared<ASTDecExpr>(*ident, expr);
+		retVal = mArena.make<ASTDecExpr>(*ident, expr);
 	}
 	
 	return retVal;
 }
 
 // &id[ Expr ]
-std::shared_ptr<ASTExpr> Parser::parseAddrOfArrayFactor() {
-	std::shared_ptr<ASTExpr> retVal;
+ASTExpr * Parser::parseAddrOfArrayFactor() {
+	ASTExpr * retVal = nullptr;
 	
 	if (peekAndConsume(TokenType::Addr)) {
-		if (!peekIsOneOf({TokenType::Identifier})) throw ParseExceptMsg("& must be followed by an identifier.");
+		if (mCurrToken->mType != TokenType::Identifier) {
+			syntaxError("& must be followed by an identifier.");
+			return nullptr;
+		}
 
-		Identifier * ident = getVariable(mCurrToken.mStr);
+		Identifier * ident = getVariable(mCurrToken->mAtom);
 
 		consumeToken();
 
-		matchToken(TokenType::LBracket);
+		if (!matchToken(TokenType::LBracket)) return nullptr;
 
-		std::shared_ptr<ASTExpr> expr = parseExpr();
+		ASTExpr * expr = parseExpr();
 		
-        if (!expr) throw ParseExceptMsg("Missing required subscript expression.");
+        if (!expr) {
+			syntaxError("Missing required subscript expression.");
+			return nullptr;
+		}
 		
-        matchToken(TokenType::RBracket);
+        if (!matchToken(TokenType::RBracket)) return nullptr;
 
-		retVal = std::make_shared<ASTAddrOfArray>(std::make_shared<ASTArrayExpr>(*ident, expr));
+		retVal = mArena.make<ASTAddrOfArray>(mArena.make<ASTArrayExpr>(*ident, expr));
 	}
 	
 	return retVal;
@@ -0,0 +1,120 @@
+#include <string_view>
+#include <unordered_map>
+#include "../scan/scan.h"
+#include "astNodes.h"
+#include "symbols.h"
+#include "parse.h"
+
+/*
+reachability mode: only the functions the roots (main unless an export list is given) call, directly or through
+other functions, are kept and the rest never make it to codegen
+
+a batch scanned source is checked before the parse so the bodies nobody calls can be skipped w/o building an AST
+for them. that check only has the tokens to go on so every identifier followed by a ( in a live body counts as a
+call to every function of that name, which can keep a function too many but never one too few. the functions that
+are parsed are then pruned again w the exact call graph the parse recorded from its ASTFuncExpr nodes, which is all
+there is for a streamed source
+
+a skipped body is not checked at all so errors in code that is never called are not reported in this mode
+*/
+
+void Parser::markLive() {
+	const TokenStore& tokens = mScanner.mTokens;
+
+	// the bodies of each function name, the name is the identifier in front of the ( ) before the {
+	std::unordered_map<std::string_view, std::vector<std::size_t>> bodiesOf;
+	std::vector<std::size_t> work;
+
+	for (std::size_t b = 0; b < mBodies.size(); ++b) {
+		std::size_t i = mBodies[b].mOpen;
+		std::size_t depth = 0;
+		bool named = false;
+
+		// back from the ) to its (
+		while (i > 0) {
+			TokenType type = tokens.type(--i);
+
+			if (type == TokenType::RParen) {
+				++depth;
+			} else if (type == TokenType::LParen) {
+				if (--depth == 0) break;
+			} else if (depth == 0 || type == TokenType::LBrace || type == TokenType::RBrace || type == TokenType::SemiColon) {
+				break;
+			}
+		}
+
+		if (depth == 0 && tokens.type(i) == TokenType::LParen && i > 0 && tokens.type(i - 1) == TokenType::Identifier) {
+			bodiesOf[mScanner.lexeme(TokenType::Identifier, tokens.offset(i - 1))].push_back(b);
+			named = true;
+		}
+
+		mBodies[b].mLive = !named;
+
+		// a body w/o a name it could be called by is parsed as usual so the calls in it count too
+		if (!named) work.push_back(b);
+	}
+
+	auto reach = [this, &bodiesOf, &work](std::string_view name) {
+		auto found = bodiesOf.find(name);
+
+		if (found == bodiesOf.end()) return;
+
+		for (std::size_t b : found->second) {
+			if (!mBodies[b].mLive) {
+				mBodies[b].mLive = true;
+				work.push_back(b);
+			}
+		}
+	};
+
+	for (const std::string& root : mRoots) reach(root);
+
+	while (!work.empty()) {
+		BodyRange range = mBodies[work.back()];
+		work.pop_back();
+
+		for (std::size_t i = range.mOpen + 1; i < range.mClose; ++i) {
+			if (tokens.type(i) == TokenType::Identifier && tokens.type(i + 1) == TokenType::LParen) {
+				reach(mScanner.lexeme(TokenType::Identifier, tokens.offset(i)));
+			}
+		}
+	}
+}
+
+void Parser::dropUnreachable() {
+	std::vector<bool> reached(mFuncCount, false);
+	std::vector<ASTFunc *> work;
+
+	for (const std::string& root : mRoots) {
+		Identifier * ident = mSymbolTable.getIdentifier(root);
+
+		// not an error in the source so it is left for the driver to report
+		if (!ident || !ident->getFunction()) {
+			mMissingRoots.push_back(root);
+			continue;
+		}
+
+		work.push_back(ident->getFunction());
+	}
+
+	while (!work.empty()) {
+		ASTFunc * func = work.back();
+		work.pop_back();
+
+		if (reached[func->getIndex()]) continue;
+
+		reached[func->getIndex()] = true;
+
+		for (ASTFunc * callee : func->getCallees()) {
+			if (!reached[callee->getIndex()]) work.push_back(callee);
+		}
+	}
+
+	ASTProg * prog = mArena.make<ASTProg>();
+
+	for (ASTFunc * func : mRoot->getFunctions()) {
+		if (reached[func->getIndex()]) prog->addFunction(mArena, func);
+	}
+
+	mRoot = prog;
+}
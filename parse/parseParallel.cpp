@@ -0,0 +1,176 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "../scan/scan.h"
+#include "astNodes.h"
+#include "symbols.h"
+#include "parse.h"
+
+/*
+a function body only depends on the functions declared before it, its arguments and the global scope so once every
+function is declared the bodies can be parsed independently
+
+the pre-pass brace matches the stored token types to find every top level { } w/o parsing anything, then the program
+is parsed as usual except that a function whose body starts at one of those { is declared (name, return type and
+arguments in its own scope) and its body is left for later, the parse jumps straight past the } to the next function
+
+the workers then pick the bodies up in order, each w its own arena, token reader and symbol table view that starts
+out w the global scope and resumes the scope of the functions arguments. the identifiers of the global scope are only
+read from here on so they are shared as is, a worker only sees the functions declared up to its own (see
+getVariable) so the result is the same as a serial parse
+
+a broken body resyncs at the } of its range instead of wherever the serial parse would have, so the errors after a
+syntax error inside a body can differ from a serial parse of the same file
+*/
+
+void Parser::skimBodies() noexcept {
+	const TokenStore& tokens = mScanner.mTokens;
+	std::size_t depth = 0;
+	std::size_t open = 0;
+
+	for (std::size_t i = 0; i < tokens.size(); ++i) {
+		TokenType type = tokens.type(i);
+
+		if (type == TokenType::LBrace) {
+			if (depth++ == 0) open = i;
+		} else if (type == TokenType::RBrace && depth > 0) {
+			if (--depth == 0) mBodies.push_back({open, i, true});
+		}
+	}
+
+	// an unclosed body runs to the EOF
+	if (depth > 0) mBodies.push_back({open, tokens.size() - 1, true});
+}
+
+const Parser::BodyRange * Parser::bodyAt() noexcept {
+	std::size_t at = mScanner.tokenIndex();
+
+	// functions are reached in source order so the blocks before this one are done w
+	while (mNextBody < mBodies.size() && mBodies[mNextBody].mOpen < at) ++mNextBody;
+
+	// not at the top level e.g. a recovery landed inside a block, just parse it here
+	if (mNextBody == mBodies.size() || mBodies[mNextBody].mOpen != at) return nullptr;
+
+	return &mBodies[mNextBody++];
+}
+
+void Parser::skipBody(const BodyRange& range) noexcept {
+	mScanner.readRange(range.mClose, mScanner.tokenCount());
+	mCurrToken = &mScanner.peekToken();
+
+	consumeToken();
+}
+
+void Parser::deferBody(ASTFunc * func, const BodyRange& range) noexcept {
+	mJobs.push_back({func, range, mErrors.size(), {}, false, false});
+
+	skipBody(range);
+}
+
+void Parser::parseBodies() {
+	unsigned threads = std::min<std::size_t>(mThreads, mJobs.size());
+
+	// a worker per thread, the tables outlive them since the AST points at the identifiers they declared
+	std::vector<std::unique_ptr<Scanner>> readers;
+	std::vector<std::unique_ptr<Parser>> workers;
+
+	for (unsigned i = 0; i < threads; ++i) {
+		readers.emplace_back(mScanner.reader());
+		mViews.emplace_back(new SymbolTable(&mSymbolTable));
+		workers.emplace_back(new Parser(*this, *readers.back(), *mViews.back()));
+	}
+
+	// bodies are handed out one at a time so a few long ones dont hold up a thread
+	std::atomic<std::size_t> next {0};
+
+	auto work = [this, &next](Parser& worker) {
+		for (std::size_t i = next++; i < mJobs.size(); i = next++) worker.parseBody(mJobs[i]);
+	};
+
+	std::vector<std::thread> pool;
+
+	for (unsigned i = 1; i < threads; ++i) pool.emplace_back(work, std::ref(*workers[i]));
+
+	work(*workers[0]);
+
+	for (std::thread& t : pool) t.join();
+
+	for (auto& worker : workers) {
+		mArena.adopt(worker->mArena);
+
+		mNeedPrintf = mNeedPrintf || worker->mNeedPrintf;
+#ifdef CRISP_PARSE_STATS
+		mExprCount += worker->mExprCount;
+		mExprCalls += worker->mExprCalls;
+#endif
+	}
+
+	// the errors of each body go in after the ones reported before it was reached
+	std::vector<Diagnostic> errors;
+	std::size_t from = 0;
+	bool failed = false;
+
+	for (BodyJob& job : mJobs) {
+		for (; from < job.mErrorsBefore; ++from) errors.emplace_back(std::move(mErrors[from]));
+		for (Diagnostic& error : job.mErrors) errors.emplace_back(std::move(error));
+
+		failed = failed || job.mFailed;
+		mErrorsDropped = mErrorsDropped || job.mErrorsDropped;
+	}
+
+	for (; from < mErrors.size(); ++from) errors.emplace_back(std::move(mErrors[from]));
+
+	mErrors.swap(errors);
+
+	// each body stops at the limit on its own, together they are cut back to it in source order
+	if (mErrorLimit && mErrors.size() > mErrorLimit) {
+		mErrors.erase(mErrors.begin() + mErrorLimit, mErrors.end());
+		mErrorsDropped = true;
+	}
+
+	// functions w a broken body are dropped like a serial parse does
+	if (failed) {
+		ASTProg * prog = mArena.make<ASTProg>();
+		std::size_t job = 0;
+
+		for (ASTFunc * func : mRoot->getFunctions()) {
+			while (job < mJobs.size() && mJobs[job].mFunc->getIndex() < func->getIndex()) ++job;
+
+			if (job == mJobs.size() || mJobs[job].mFunc != func || !mJobs[job].mFailed) prog->addFunction(mArena, func);
+		}
+
+		mRoot = prog;
+	}
+
+	mJobs.clear();
+}
+
+void Parser::parseBody(BodyJob& job) noexcept {
+	ASTFunc * func = job.mFunc;
+
+	mScanner.readRange(job.mRange.mOpen, job.mRange.mClose + 1);
+	mCurrToken = &mScanner.peekToken();
+
+	mSymbolTable.resumeFunction(&func->getScopeTable());
+	mCurrReturnType = func->getReturnType();
+	mCurrFunc = func;
+	mVisibleFuncs = func->getIndex() + 1;
+	mPanic = false;
+	mErrorAt = SIZE_MAX;
+
+	// same as the end of parseFunction
+	ASTCompoundStmt * body = parseCompoundStmt(true);
+
+	if (mPanic && recover(TokenSet {TokenType::RBrace})) consumeToken();
+
+	mSymbolTable.exitScope();
+
+	if (body) func->setBody(body);
+	else job.mFailed = true;
+
+	job.mErrors.swap(mErrors);
+	mErrors.clear();
+
+	job.mErrorsDropped = mErrorsDropped;
+	mErrorsDropped = false;
+}
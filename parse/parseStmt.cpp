@@ -1,15 +1,15 @@
-#include "../error/parseExcept.h"
 #include "astNodes.h"
 #include "parse.h"
+#include "../error/syntaxError.h"
 
-std::shared_ptr<ASTDecl> Parser::parseDecl() {
-	std::shared_ptr<ASTDecl> retVal;
+ASTDecl * Parser::parseDecl() {
+	ASTDecl * retVal = nullptr;
 	
     // a decl must start with int, char, or double
-	if (peekIsOneOf({TokenType::KeyChar, TokenType::KeyDouble, TokenType::KeyInt})) {
+	if (peekIsOneOf(Grammar::FirstDecl)) {
 		Type declType = Type::Void;
 
-        switch (mCurrToken.mType) {
+        switch (mCurrToken->mType) {
 			case TokenType::KeyInt:
 				declType = Type::Int;
 				break;
@@ -25,242 +25,323 @@ std::shared_ptr<ASTDecl> Parser::parseDecl() {
 		
 		consumeToken();
 		
-		// set this to @@variable for now we will later change it assuming we parse the identifier properly
-		Identifier * ident = mSymbolTable.getIdentifier("@@variable");
+		// a syntax error in here is recovered from by parseStmt
+		if (mCurrToken->mType != TokenType::Identifier) {
+			syntaxError("Type must be followed by identifier");
+			return nullptr;
+		}
 		
-		// now we must get an identifier so go into a try
-		try {
-			if (mCurrToken.mType != TokenType::Identifier) {
-				throw ParseExceptMsg("Type must be followed by identifier");
-			}
-			
-			const std::string& tokenStr = mCurrToken.mStr;
+		std::string_view tokenStr = mCurrToken->mStr;
 
-			if (mSymbolTable.isDeclaredInScope(tokenStr)) {
-                reportSemantError(std::string("Invalid redeclaration of identifier '") + std::string(tokenStr) + "'");
-            }
+		// a redeclaration is left as the bogus @@variable so the parse continues
+		Identifier * ident = mSymbolTable.getIdentifier(Atoms::Variable);
 
-            // if redeclaration nothing will happen
-			ident = mSymbolTable.createIdentifier(tokenStr); 
-			
-			consumeToken();
-			
-			// is this an array declaration?
-			if (peekAndConsume(TokenType::LBracket)) {
-				std::shared_ptr<ASTConstantExpr> constExpr;
-
-                switch (declType) {
-                    case Type::Int:
-                    	declType = Type::IntArray;
-
-                        // int arrays must have a constant size defined because crisp does not support initializer lists
-                        constExpr = parseConstantFactor();
-
-                        if (!constExpr) {
-                            reportSemantError("Int arrays must have a defined constant size");
-                        }
-                        
-                        break;
-                    case Type::Char:
-                        declType = Type::CharArray;
-					
-                        // for character we support both constant size or implict size if it is assigned to a constant string
-						constExpr = parseConstantFactor();
-
-                        break;
-                    case Type::Double:
-                    	declType = Type::DoubleArray;
-
-                        // double arrays must have a constant size defined because crisp does not support initializer lists
-                        constExpr = parseConstantFactor();
-
-                        if (!constExpr) {
-                            reportSemantError("Double arrays must have a defined constant size");
-                        }
-                                                
-                        break;
-                    default:
-                        break;
-                }
+		if (mSymbolTable.isDeclaredInScope(mCurrToken->mAtom)) {
+            reportSemantError(std::string("Invalid redeclaration of identifier '") + std::string(tokenStr) + "'");
+        } else {
+			ident = mSymbolTable.createIdentifier(mCurrToken->mAtom);
+		}
+		
+		consumeToken();
+		
+		// is this an array declaration?
+		if (peekAndConsume(TokenType::LBracket)) {
+			ASTConstantExpr * constExpr = nullptr;
+
+            switch (declType) {
+                case Type::Int:
+                	declType = Type::IntArray;
+
+                    // int arrays must have a constant size defined because crisp does not support initializer lists
+                    constExpr = parseConstantFactor();
 
-                if (constExpr) {
-                    int count = constExpr->getValue();
+                    if (!constExpr) {
+                        reportSemantError("Int arrays must have a defined constant size");
+                    }
+                    
+                    break;
+                case Type::Char:
+                    declType = Type::CharArray;
+				
+                    // for character we support both constant size or implict size if it is assigned to a constant string
+					constExpr = parseConstantFactor();
+
+                    break;
+                case Type::Double:
+                	declType = Type::DoubleArray;
+
+                    // double arrays must have a constant size defined because crisp does not support initializer lists
+                    constExpr = parseConstantFactor();
 
-                    if (count <= 0 || count > 65536) {
-                        reportSemantError("Arrays must have a min of 1 and a max of 65536 elements");
+                    if (!constExpr) {
+                        reportSemantError("Double arrays must have a defined constant size");
                     }
+                                            
+                    break;
+                default:
+                    break;
+            }
+
+            if (constExpr) {
+                int count = constExpr->getValue();
 
-                    ident->setArrayCount(count);
-                } else {
-                    // we will determine this later in the parse
-                    ident->setArrayCount(0);
+                if (count <= 0 || count > 65536) {
+                    reportSemantError("Arrays must have a min of 1 and a max of 65536 elements");
                 }
-				
-				matchToken(TokenType::RBracket);
-			}
+
+                ident->setArrayCount(count);
+            } else {
+                // we will determine this later in the parse
+                ident->setArrayCount(0);
+            }
 			
-			ident->setType(declType);
+			if (!matchToken(TokenType::RBracket)) return nullptr;
+		}
+		
+		ident->setType(declType);
+		
+		ASTExpr * assignExpr = nullptr;
+		
+		// optionally this decl may have an assignment
+		std::size_t offset = mCurrToken->mOffset;
 			
-			std::shared_ptr<ASTExpr> assignExpr;
+		if (peekAndConsume(TokenType::Assign)) {
+			// we do not allow assignment for int arrays
+			switch (declType) {
+				case Type::IntArray:
+					reportSemantError("crisp does not allow assignment of int array declarations");
+					break;
+				case Type::DoubleArray:
+					reportSemantError("crisp does not allow assignment of double array declarations");
+					break;
+				default:
+					break;
+			}
 			
-			// optionally this decl may have an assignment
-			int col = mCurrToken.mCol;
-				
-			if (peekAndConsume(TokenType::Assign)) {
-				// we do not allow assignment for int arrays
-				switch (declType) {
-					case Type::IntArray:
-						reportSemantError("crisp does not allow assignment of int array declarations");
-						break;
-					case Type::DoubleArray:
-						reportSemantError("crisp does not allow assignment of double array declarations");
-						break;
-					default:
-						break;
-				}
-				
-				assignExpr = parseExpr();
-				if (!assignExpr) {
-					throw ParseExceptMsg("Invalid expression after = in declaration");
-				}
+			assignExpr = parseExpr();
+			if (!assignExpr) {
+				syntaxError("Invalid expression after = in declaration");
+				return nullptr;
+			}
 
-				// if lhs and rhs don not match
-				if (ident->getType() != assignExpr->getType()) {
-					std::string err("Cannot assign an expression of type ");
-                    err += getTypeText(assignExpr->getType());
-					err += " to ";
-					err += getTypeText(ident->getType());
+			// if lhs and rhs don not match
+			if (ident->getType() != assignExpr->getType()) {
+				std::string err("Cannot assign an expression of type ");
+                err += getTypeText(assignExpr->getType());
+				err += " to ";
+				err += getTypeText(ident->getType());
 
-					reportSemantError(err, col);
-				}
+				reportSemantError(err, offset);
+			}
 
-				// if this is a character array we need to do extra checks
-				if (ident->getType() == Type::CharArray) {
-					std::shared_ptr<ASTStringExpr> rhs = std::dynamic_pointer_cast<ASTStringExpr>(assignExpr);
-					
-                    if (rhs) {
-						// if we have a declared size we need to make sure
-						// there is enough room to fit the requested string
-						// otherwise we need to set our size
-						if (ident->getArrayCount() == 0) {
-                            ident->setArrayCount(rhs->getLength() + 1);
-                        } else if (ident->getArrayCount() < (rhs->getLength() + 1)) {
-                            reportSemantError("Declared array cannot fit string");
-                        }
-					}
+			// if this is a character array we need to do extra checks
+			if (ident->getType() == Type::CharArray) {
+				ASTStringExpr * rhs = dyn_cast<ASTStringExpr>(assignExpr);
+				
+                if (rhs) {
+					// if we have a declared size we need to make sure
+					// there is enough room to fit the requested string
+					// otherwise we need to set our size
+					if (ident->getArrayCount() == 0) {
+                        ident->setArrayCount(rhs->getLength() + 1);
+                    } else if (ident->getArrayCount() < (rhs->getLength() + 1)) {
+                        reportSemantError("Declared array cannot fit string");
+                    }
 				}
-			} else if (ident->getType() == Type::CharArray && ident->getArrayCount() == 0) {
-				reportSemantError("char array must have declared size if there is no assignment");
-			}
-			
-			matchToken(TokenType::SemiColon);
-			
-			retVal = std::make_shared<ASTDecl>(*ident, assignExpr);
-		} catch (ParseExcept& e) {
-			reportError(e);
-			
-			// skip all the tokens until the next semi-colon
-			consumeUntil(TokenType::SemiColon);
-			
-			if (mCurrToken.mType == TokenType::EndOfFile) {
-				throw EOFExcept();
 			}
-			
-			// grab the semi-colon also
-			consumeToken();
-			
-			// put in a decl here with the bogus identifier
-			// "@@error" this is so the parse will continue to the
-			// next decl if there is one
-			retVal = std::make_shared<ASTDecl>(*ident);
+		} else if (ident->getType() == Type::CharArray && ident->getArrayCount() == 0) {
+			reportSemantError("char array must have declared size if there is no assignment");
 		}
+		
+		if (!matchToken(TokenType::SemiColon)) return nullptr;
+		
+		retVal = mArena.make<ASTDecl>(*ident, assignExpr);
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTStmt> Parser::parseStmt() {
-	std::shared_ptr<ASTStmt> retVal;
-	
-    try {
-		if ((retVal = parseCompoundStmt()));
-        else if ((retVal = parseForStmt()));
-		else if ((retVal = parseReturnStmt()));
-		else if ((retVal = parseWhileStmt()));
-		else if ((retVal = parseExprStmt()));
-		else if ((retVal = parseNullStmt()));
-		else if ((retVal = parseIfStmt()));
+ASTStmt * Parser::parseStmt() {
+	ASTStmt * retVal = nullptr;
+
+	// e.g. the } that ends the block
+	if (!peekIsOneOf(Grammar::FirstStmt)) return nullptr;
+
+	if (mDepth == mMaxDepth) {
+		tooDeep();
+	} else {
+		++mDepth;
+
+		// the first one to hit a syntax error stops the rest from being tried
+		if ((retVal = parseCompoundStmt()) || mPanic);
+		else if ((retVal = parseForStmt()) || mPanic);
+		else if ((retVal = parseReturnStmt()) || mPanic);
+		else if ((retVal = parseWhileStmt()) || mPanic);
+		else if ((retVal = parseExprStmt()) || mPanic);
+		else if ((retVal = parseNullStmt()) || mPanic);
+		else if ((retVal = parseIfStmt()) || mPanic);
 		else if ((retVal = parseDecl()));
-	} catch (ParseExcept& e) {
-		reportError(e);
-		
-		// skip all the tokens until the next semi-colon or right brace
-		consumeUntil(TokenType::SemiColon);
-		
-		if (mCurrToken.mType == TokenType::EndOfFile) {
-			throw EOFExcept();
-		}
-		
-		// grab the semi-colon or right brace 
-		consumeToken();
+
+		--mDepth;
+	}
+
+	if (mPanic) {
+		// skip the rest of the broken statement, a block/keyword/type starts the next one
+		if (!recover(Grammar::FollowStmt)) return nullptr;
+
+		// a semi-colon ends the broken one so grab that too
+		peekAndConsume(TokenType::SemiColon);
 		
 		// put in a null statement here so we can try to continue
-		retVal = std::make_shared<ASTNullStmt>();
+		retVal = mArena.make<ASTNullStmt>();
 	}
 	
 	return retVal;
 }
 
 // always enter new scope
-std::shared_ptr<ASTCompoundStmt> Parser::parseCompoundStmt(bool isFuncBody) {
-	std::shared_ptr<ASTCompoundStmt> retVal;
+ASTCompoundStmt * Parser::parseCompoundStmt(bool isFuncBody) {
+	ASTCompoundStmt * retVal = nullptr;
 	
 	if (peekAndConsume(TokenType::LBrace)) {
 		if (!isFuncBody) mSymbolTable.enterScope();
 
-		retVal = std::make_shared<ASTCompoundStmt>();
+		retVal = mArena.make<ASTCompoundStmt>();
 
-		std::shared_ptr<ASTStmt> stmt; 
-		stmt = parseStmt();
+		// a block inside this one is opened right here rather than through parseStmt, the blocks around it wait on
+		// mOpenBlocks so deeply nested blocks dont take a stack frame each (they still count against the budget)
+		std::size_t base = mOpenBlocks.size();
 
-		while (stmt) {
-			retVal->addStmt(stmt);
-			stmt = parseStmt();
-		}
+		for (;;) {
+			if (mCurrToken->mType == TokenType::LBrace && mDepth < mMaxDepth) {
+				++mDepth;
+				consumeToken();
+				mSymbolTable.enterScope();
+
+				mOpenBlocks.push_back(retVal);
+				retVal = mArena.make<ASTCompoundStmt>();
+
+				continue;
+			}
+
+			ASTStmt * stmt = parseStmt();
+
+			if (stmt) {
+				retVal->addStmt(mArena, stmt);
+				continue;
+			}
+
+			if (!mPanic && !isAtEnd() && mCurrToken->mType != TokenType::RBrace) {
+				// a token that cant start a statement, skip it and carry on w the rest of the block
+				syntaxError(SyntaxError::mismatch(TokenType::RBrace, mCurrToken->mType, mCurrToken->mStr));
+				consumeToken(false);
 
-		matchToken(TokenType::RBrace);
+				if (recover(Grammar::FollowStmt)) continue;
+			}
+
+			// still panicking if a statement ran into the end of the file
+			if (!mPanic) matchToken(TokenType::RBrace);
+
+			if (mOpenBlocks.size() == base) break;
+
+			// back out to the block around it
+			mSymbolTable.exitScope();
+			--mDepth;
+
+			ASTCompoundStmt * inner = retVal;
+
+			retVal = mOpenBlocks.back();
+			mOpenBlocks.pop_back();
+
+			if (!mPanic) {
+				retVal->addStmt(mArena, inner);
+				continue;
+			}
+
+			// the inner block is broken, same as parseStmt does w it. at the end of the file the next parseStmt
+			// comes back empty so the blocks around it end too
+			if (recover(Grammar::FollowStmt)) {
+				peekAndConsume(TokenType::SemiColon);
+				retVal->addStmt(mArena, mArena.make<ASTNullStmt>());
+			}
+		}
 
 		if (!isFuncBody) mSymbolTable.exitScope();
+
+		if (mPanic) return nullptr;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTIfStmt> Parser::parseIfStmt() {
-	std::shared_ptr<ASTIfStmt> retVal;
-	
-	if (peekAndConsume(TokenType::KeyIf)) {
-		matchToken(TokenType::LParen);
+ASTIfStmt * Parser::parseIfStmt() {
+	if (!peekAndConsume(TokenType::KeyIf)) return nullptr;
 
-		std::shared_ptr<ASTExpr> expr = parseExpr();
+	// the ifs of an else if chain are parsed in this loop and each one hooked up as the else of the one before it,
+	// so a long chain doesnt go through parseStmt for every else
+	ASTIfStmt * retVal = parseIfClause();
+	ASTIfStmt * prev = nullptr;
+	ASTIfStmt * last = retVal;
 
-		if (!expr) reportError("Invalid condition for if statement");
+	while (last && peekAndConsume(TokenType::KeyElse)) {
+		if (peekAndConsume(TokenType::KeyIf)) {
+			prev = last;
+			last = parseIfClause();
 
-		matchToken(TokenType::RParen);
-		
-		std::shared_ptr<ASTStmt> stmt = parseStmt();
-		std::shared_ptr<ASTStmt> elseStmt;
+			if (last) prev->setElseStmt(last);
+
+			continue;
+		}
 
-		if (peekAndConsume(TokenType::KeyElse)) elseStmt = parseStmt();
+		ASTStmt * elseStmt = parseStmt();
 
-		retVal = std::make_shared<ASTIfStmt>(expr, stmt, elseStmt);
+		if (!elseStmt) {
+			syntaxError("Invalid body for else statement");
+			last = nullptr;
+		} else {
+			last->setElseStmt(elseStmt);
+		}
+
+		break;
+	}
+
+	if (!last) {
+		// a broken if further down the chain is recovered from as the else statement it is
+		if (!prev || !recover(Grammar::FollowStmt)) return nullptr;
+
+		peekAndConsume(TokenType::SemiColon);
+		prev->setElseStmt(mArena.make<ASTNullStmt>());
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTForStmt> Parser::parseForStmt() {
-	std::shared_ptr<ASTForStmt> retVal;
+ASTIfStmt * Parser::parseIfClause() {
+	if (!matchToken(TokenType::LParen)) return nullptr;
+
+	ASTExpr * expr = parseExpr();
+
+	if (mPanic) return nullptr;
+
+	if (!expr) {
+		syntaxError("Invalid condition for if statement");
+		return nullptr;
+	}
+
+	if (!matchToken(TokenType::RParen)) return nullptr;
+	
+	ASTStmt * stmt = parseStmt();
+
+	if (!stmt) {
+		syntaxError("Invalid body for if statement");
+		return nullptr;
+	}
+
+	return mArena.make<ASTIfStmt>(expr, stmt, nullptr);
+}
+
+ASTForStmt * Parser::parseForStmt() {
+	ASTForStmt * retVal = nullptr;
 	
 	if (peekAndConsume(TokenType::KeyFor)) {
 		// TODO
@@ -268,60 +349,73 @@ std::shared_ptr<ASTForStmt> Parser::parseForStmt() {
 		// matchToken(TokenType::LParen);
 
         // // should be decl or assignment or empty
-		// // std::shared_ptr<ASTExpr> expr = parseExpr();
+		// // ASTExpr * expr = parseExpr();
 
 		// if (!expr) throw ParseExceptMsg("Invalid condition for if statement");
 		
         // matchToken(TokenType::RParen);
 
-		// std::shared_ptr<ASTStmt> stmt = parseStmt();
-		// std::shared_ptr<ASTStmt> elseStmt;
+		// ASTStmt * stmt = parseStmt();
+		// ASTStmt * elseStmt = nullptr;
 
 		// if (peekAndConsume(TokenType::KeyElse)) elseStmt = parseStmt();
 
-		// retVal = std::make_shared<ASTIfStmt>(expr, stmt, elseStmt);
+		// retVal = mArena.make<ASTIfStmt>(expr, stmt, elseStmt);
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTWhileStmt> Parser::parseWhileStmt() {
-	std::shared_ptr<ASTWhileStmt> retVal;
+ASTWhileStmt * Parser::parseWhileStmt() {
+	ASTWhileStmt * retVal = nullptr;
 	
 	if (peekAndConsume(TokenType::KeyWhile)) {
-		std::shared_ptr<ASTExpr> expr;
-		std::shared_ptr<ASTStmt> stmt;
+		ASTExpr * expr = nullptr;
+		ASTStmt * stmt = nullptr;
 		
-        matchToken(TokenType::LParen);
+        if (!matchToken(TokenType::LParen)) return nullptr;
 		
         expr = parseExpr();
 		
-        if (!expr) throw ParseExceptMsg("Invalid condition for while statement");
+        if (!expr) {
+			syntaxError("Invalid condition for while statement");
+			return nullptr;
+		}
 		
-        matchToken(TokenType::RParen);
+        if (!matchToken(TokenType::RParen)) return nullptr;
 
 		stmt = parseStmt();
 
-		retVal = std::make_shared<ASTWhileStmt>(expr, stmt);
+		if (!stmt) {
+			syntaxError("Invalid body for while statement");
+			return nullptr;
+		}
+
+		retVal = mArena.make<ASTWhileStmt>(expr, stmt);
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTReturnStmt> Parser::parseReturnStmt() {
-	std::shared_ptr<ASTReturnStmt> retVal;
+ASTReturnStmt * Parser::parseReturnStmt() {
+	ASTReturnStmt * retVal = nullptr;
 	
 	if (peekAndConsume(TokenType::KeyReturn)) {
-		if (peekIsOneOf({TokenType::SemiColon})) {
-			retVal = std::make_shared<ASTReturnStmt>(nullptr);
+		if (mCurrToken->mType == TokenType::SemiColon) {
+			retVal = mArena.make<ASTReturnStmt>(nullptr);
 
 			if (mCurrReturnType != Type::Void) reportSemantError("Invalid empty return in non-void function");
 			
             consumeToken();
 		} else {
-			int col = mCurrToken.mCol;
+			std::size_t offset = mCurrToken->mOffset;
 			
-            std::shared_ptr<ASTExpr> expr = parseExpr();
+            ASTExpr * expr = parseExpr();
+
+			if (!expr) {
+				syntaxError("Invalid expression in return statement");
+				return nullptr;
+			}
 
 			// no conversion atm
 			if (mCurrReturnType != expr->getType()) {
@@ -329,34 +423,34 @@ std::shared_ptr<ASTReturnStmt> Parser::parseReturnStmt() {
 				err += getTypeText(mCurrReturnType);
 				err += " in return statement";
 
-				reportSemantError(err, col);
+				reportSemantError(err, offset);
 			}
 
-			retVal = std::make_shared<ASTReturnStmt>(expr);
+			retVal = mArena.make<ASTReturnStmt>(expr);
 			
-            matchToken(TokenType::SemiColon);
+            if (!matchToken(TokenType::SemiColon)) return nullptr;
 		}
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTExprStmt> Parser::parseExprStmt() {
-	std::shared_ptr<ASTExprStmt> retVal;
+ASTExprStmt * Parser::parseExprStmt() {
+	ASTExprStmt * retVal = nullptr;
 	
-	std::shared_ptr<ASTExpr> e = parseExpr();
+	ASTExpr * e = parseExpr();
     if (e) {
-		retVal = std::make_shared<ASTExprStmt>(e);
-		matchToken(TokenType::SemiColon);
+		retVal = mArena.make<ASTExprStmt>(e);
+		if (!matchToken(TokenType::SemiColon)) return nullptr;
 	}
 	
 	return retVal;
 }
 
-std::shared_ptr<ASTNullStmt> Parser::parseNullStmt() {
-	std::shared_ptr<ASTNullStmt> retVal;
+ASTNullStmt * Parser::parseNullStmt() {
+	ASTNullStmt * retVal = nullptr;
 	
-	if (peekAndConsume(TokenType::SemiColon)) retVal = std::make_shared<ASTNullStmt>();
+	if (peekAndConsume(TokenType::SemiColon)) retVal = mArena.make<ASTNullStmt>();
 	
 	return retVal;
 }
\ No newline at end of file
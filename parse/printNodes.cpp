@@ -1,6 +1,95 @@
 #include <ostream>
+#include <utility>
+#include <vector>
+#include "astCache.h"
 #include "astNodes.h"
 
+// the text of a node is shared w ASTCache::print at the bottom which prints the cached records the same way
+namespace {
+    void printReturnType(std::ostream& output, Type type) noexcept {
+        switch (type) {
+            case Type::Void:
+                output << "void ";
+                break;
+            case Type::Int:
+                output << "int ";
+                break;
+            case Type::Char:
+                output << "char ";
+                break;
+            default:
+                output << "Shouldn't have gotten here. ";
+                break;
+        }
+    }
+
+    void printArgType(std::ostream& output, Type type) noexcept {
+        switch (type) {
+            case Type::Void:
+                output << "void ";
+                break;
+            case Type::Int:
+                output << "int ";
+                break;
+            case Type::Char:
+                output << "char ";
+                break;
+            case Type::IntArray:
+                output << "int[] ";
+                break;
+            case Type::CharArray:
+                output << "char[] ";
+                break;
+            default:
+                output << "Shouldn't have gotten here...";
+                break;
+        }
+    }
+
+    void printDeclType(std::ostream& output, Type type, int count) noexcept {
+        switch (type) {
+            case Type::Void:
+                output << "void";
+                break;
+            case Type::Int:
+                output << "int";
+                break;
+            case Type::Char:
+                output << "char";
+                break;
+            case Type::IntArray:
+                output << "int[" << count << ']';
+                break;
+            case Type::CharArray:
+                output << "char[" << count << ']';
+                break;
+            default:
+                output << "Shouldn't have gotten here...";
+                break;
+        }
+    }
+
+    void printBinaryOp(std::ostream& output, NodeKind kind, TokenType op) noexcept {
+        switch (kind) {
+            case NodeKind::AssignOp:
+                output << "AssignOp " << Token::mToString[op] << ':' << std::endl;
+                break;
+            case NodeKind::LogicalAnd:
+                output << "LogicalAnd: " << std::endl;
+                break;
+            case NodeKind::LogicalOr:
+                output << "LogicalOr: " << std::endl;
+                break;
+            case NodeKind::BinaryCmpOp:
+                output << "BinaryCmp " << Token::mToString[op] << ':' << std::endl;
+                break;
+            default:
+                output << "BinaryMath " << Token::mToString[op] << ':' << std::endl;
+                break;
+        }
+    }
+}
+
 void ASTProg::printNode(std::ostream& output, int depth) const noexcept {
     for (int i = 0; i < depth; i++) {
         output << "---";
@@ -20,20 +109,7 @@ void ASTFunc::printNode(std::ostream& output, int depth) const noexcept {
 
     output << "Function: ";
 
-    switch (mReturnType) {
-        case Type::Void:
-            output << "void ";
-            break;
-        case Type::Int:
-            output << "int ";
-            break;
-        case Type::Char:
-            output << "char ";
-            break;
-        default:
-            output << "Shouldn't have gotten here. ";
-            break;
-    }
+    printReturnType(output, mReturnType);
 
     output << mIdent.getName() << std::endl;
 
@@ -51,72 +127,35 @@ void ASTArgDecl::printNode(std::ostream& output, int depth) const noexcept {
 
     output << "ArgDecl: ";
 
-    switch (mIdent.getType()) {
-        case Type::Void:
-            output << "void ";
-            break;
-        case Type::Int:
-            output << "int ";
-            break;
-        case Type::Char:
-            output << "char ";
-            break;
-        case Type::IntArray:
-            output << "int[] ";
-            break;
-        case Type::CharArray:
-            output << "char[] ";
-            break;
-        default:
-            output << "Shouldn't have gotten here...";
-            break;
-    }
+    printArgType(output, mIdent.getType());
 
     output << mIdent.getName() << std::endl;
 }
 
-void ASTLogicalAnd::printNode(std::ostream& output, int depth) const noexcept {
-    for (int i = 0; i < depth; i++) {
-        output << "---";
-    }
+void ASTBinaryExpr::printNode(std::ostream& output, int depth) const noexcept {
+    // the binary exprs down the left side are printed on the way down and their rhs on the way back up, which is
+    // the order the recursive walk printed them in w/o a stack frame per op
+    std::vector<const ASTBinaryExpr *> chain;
+    const ASTExpr * node = this;
 
-    output << "LogicalAnd: " << std::endl;
+    for (const ASTBinaryExpr * op; (op = dyn_cast<ASTBinaryExpr>(node)); node = op->mLHS) {
+        for (int i = 0; i < depth; i++) {
+            output << "---";
+        }
 
-    mLHS->printNode(output, depth + 1);
-    mRHS->printNode(output, depth + 1);
-}
+        printBinaryOp(output, op->getKind(), op->mOp);
 
-void ASTLogicalOr::printNode(std::ostream& output, int depth) const noexcept {
-    for (int i = 0; i < depth; i++) {
-        output << "---";
+        chain.push_back(op);
+        ++depth;
     }
 
-    output << "LogicalOr: " << std::endl;
+    node->printNode(output, depth);
 
-    mLHS->printNode(output, depth + 1);
-    mRHS->printNode(output, depth + 1);
-}
-
-void ASTBinaryCmpOp::printNode(std::ostream& output, int depth) const noexcept {
-    for (int i = 0; i < depth; i++) {
-        output << "---";
+    while (!chain.empty()) {
+        chain.back()->mRHS->printNode(output, depth);
+        chain.pop_back();
+        --depth;
     }
-
-    output << "BinaryCmp " << Token::mToString[mOp] << ':' << std::endl;
-
-    mLHS->printNode(output, depth + 1);
-    mRHS->printNode(output, depth + 1);
-}
-
-void ASTBinaryMathOp::printNode(std::ostream& output, int depth) const noexcept {
-    for (int i = 0; i < depth; i++) {
-        output << "---";
-    }
-
-    output << "BinaryMath " << Token::mToString[mOp] << ':' << std::endl;
-
-    mLHS->printNode(output, depth + 1);
-    mRHS->printNode(output, depth + 1);
 }
 
 void ASTNotExpr::printNode(std::ostream& output, int depth) const noexcept {
@@ -169,17 +208,6 @@ void ASTIdentExpr::printNode(std::ostream& output, int depth) const noexcept {
     output << "IdentExpr: " << mIdent.getName() << std::endl;
 }
 
-void ASTAssignOp::printNode(std::ostream& output, int depth) const noexcept {
-    for (int i = 0; i < depth; i++) {
-        output << "---";
-    }
-    
-    output << "AssignOp " << Token::mToString[mOp] << ':' << std::endl;
-
-    mLHS->printNode(output, depth + 1);
-    mRHS->printNode(output, depth + 1);
-}
-
 void ASTArrayExpr::printNode(std::ostream& output, int depth) const noexcept {
     for (int i = 0; i < depth; i++) {
         output << "---";
@@ -234,26 +262,7 @@ void ASTDecl::printNode(std::ostream& output, int depth) const noexcept {
 
     output << "Decl: ";
     
-    switch (mIdent.getType()) {
-        case Type::Void:
-            output << "void";
-            break;
-        case Type::Int:
-            output << "int";
-            break;
-        case Type::Char:
-            output << "char";
-            break;
-        case Type::IntArray:
-            output << "int[" << mIdent.getArrayCount() << ']';
-            break;
-        case Type::CharArray:
-            output << "char[" << mIdent.getArrayCount() << ']';
-            break;
-        default:
-            output << "Shouldn't have gotten here...";
-            break;
-    }
+    printDeclType(output, mIdent.getType(), mIdent.getArrayCount());
 
     output << ' ' << mIdent.getName() << std::endl;
 
@@ -263,14 +272,42 @@ void ASTDecl::printNode(std::ostream& output, int depth) const noexcept {
 }
 
 void ASTCompoundStmt::printNode(std::ostream& output, int depth) const noexcept {
-    for (int i = 0; i < depth; i++) {
-        output << "---";
-    }
-
-    output << "CompoundStmt:" << std::endl;
-
-    for (auto stmt : mStmts) {
-        stmt->printNode(output, depth + 1);
+    // a block in a block is printed in this loop w the blocks around it on a stack (like the parser opens them)
+    std::vector<std::pair<const ASTCompoundStmt *, std::size_t>> open;
+    const ASTCompoundStmt * block = this;
+    std::size_t next = 0;
+
+    for (;;) {
+        if (next == 0) {
+            for (int i = 0; i < depth; i++) {
+                output << "---";
+            }
+
+            output << "CompoundStmt:" << std::endl;
+        }
+
+        if (next == block->mStmts.size()) {
+            if (open.empty()) break;
+
+            // back to the rest of the block around it
+            block = open.back().first;
+            next = open.back().second;
+            open.pop_back();
+            --depth;
+
+            continue;
+        }
+
+        const ASTStmt * stmt = block->mStmts[next++];
+
+        if (const ASTCompoundStmt * inner = dyn_cast<ASTCompoundStmt>(stmt)) {
+            open.emplace_back(block, next);
+            block = inner;
+            next = 0;
+            ++depth;
+        } else {
+            stmt->printNode(output, depth + 1);
+        }
     }
 }
 
@@ -288,16 +325,23 @@ void ASTReturnStmt::printNode(std::ostream& output, int depth) const noexcept {
 }
 
 void ASTIfStmt::printNode(std::ostream& output, int depth) const noexcept {
-    for (int i = 0; i < depth; i++) {
-        output << "---";
-    }
-    output << "IfStmt: " << std::endl;
+    // an else if chain is printed in this loop, each if one level deeper than the one it is the else of
+    for (const ASTIfStmt * stmt = this; stmt; ++depth) {
+        for (int i = 0; i < depth; i++) {
+            output << "---";
+        }
+        output << "IfStmt: " << std::endl;
 
-    mExpr->printNode(output, depth + 1);
-    mThenStmt->printNode(output, depth + 1);
+        stmt->mExpr->printNode(output, depth + 1);
+        stmt->mThenStmt->printNode(output, depth + 1);
 
-    if (mElseStmt) {
-        mElseStmt->printNode(output, depth + 1);
+        const ASTIfStmt * elseIf = dyn_cast<ASTIfStmt>(stmt->mElseStmt);
+
+        if (stmt->mElseStmt && !elseIf) {
+            stmt->mElseStmt->printNode(output, depth + 1);
+        }
+
+        stmt = elseIf;
     }
 }
 
@@ -329,3 +373,112 @@ void ASTNullStmt::printNode(std::ostream& output, int depth) const noexcept {
 
     output << "NullStmt" << std::endl;
 }
+
+void ASTCache::print(std::ostream& output) const noexcept {
+    // every node prints its line then its children one level deeper, in order, so the records are walked in pre
+    // order w the ones still to print on a stack (the root is the last record)
+    std::vector<std::pair<std::uint32_t, int>> todo {{mHeader->mNodes - 1, 0}};
+
+    while (!todo.empty()) {
+        std::uint32_t index = todo.back().first;
+        int depth = todo.back().second;
+        todo.pop_back();
+
+        const Node& node = mNodes[index];
+        const Ident * ident = node.mRef < mHeader->mIdents ? &mIdents[node.mRef] : nullptr;
+        std::string_view name = ident ? text(ident->mName, ident->mLength) : std::string_view();
+
+        for (int i = 0; i < depth; i++) {
+            output << "---";
+        }
+
+        // the ++ and -- exprs only print their ident
+        bool leaf = false;
+
+        switch (node.mKind) {
+            case NodeKind::Prog:
+                output << "Program:" << std::endl;
+                break;
+            case NodeKind::Func:
+                output << "Function: ";
+                printReturnType(output, node.mType);
+                output << name << std::endl;
+                break;
+            case NodeKind::ArgDecl:
+                output << "ArgDecl: ";
+                printArgType(output, ident->mType);
+                output << name << std::endl;
+                break;
+            case NodeKind::Decl:
+                output << "Decl: ";
+                printDeclType(output, ident->mType, ident->mElemCount);
+                output << ' ' << name << std::endl;
+                break;
+            case NodeKind::CompoundStmt:
+                output << "CompoundStmt:" << std::endl;
+                break;
+            case NodeKind::IfStmt:
+                output << "IfStmt: " << std::endl;
+                break;
+            case NodeKind::ReturnStmt:
+                output << (mKids[node.mFirst] == None ? "ReturnStmt: (empty)" : "ReturnStmt:") << std::endl;
+                break;
+            case NodeKind::WhileStmt:
+                output << "WhileStmt" << std::endl;
+                break;
+            case NodeKind::ExprStmt:
+                output << "ExprStmt" << std::endl;
+                break;
+            case NodeKind::NullStmt:
+                output << "NullStmt" << std::endl;
+                break;
+            case NodeKind::IdentExpr:
+                output << "IdentExpr: " << name << std::endl;
+                break;
+            case NodeKind::ArrayExpr:
+                output << "ArrayExpr: " << name << std::endl;
+                break;
+            case NodeKind::FuncExpr:
+                output << "FuncExpr: " << name << std::endl;
+                break;
+            case NodeKind::NotExpr:
+                output << "NotExpr:" << std::endl;
+                break;
+            case NodeKind::IncExpr:
+                output << "IncExpr: " << name << std::endl;
+                leaf = true;
+                break;
+            case NodeKind::DecExpr:
+                output << "DecExpr: " << name << std::endl;
+                leaf = true;
+                break;
+            case NodeKind::AddrOfArray:
+                output << "AddrOfArray:" << std::endl;
+                break;
+            case NodeKind::StringExpr:
+                output << "StringExpr: " << text(mStrings[node.mRef].mText, mStrings[node.mRef].mLength) << std::endl;
+                break;
+            case NodeKind::ConstantExpr:
+                output << "ConstantExpr: " << static_cast<int>(node.mInt) << std::endl;
+                break;
+            case NodeKind::DoubleExpr:
+                output << "DoubleExpr: " << node.mDouble << std::endl;
+                break;
+            case NodeKind::CharExpr:
+                output << "CharExpr: " << static_cast<char>(node.mInt) << std::endl;
+                break;
+            default:
+                printBinaryOp(output, node.mKind, node.mOp);
+                break;
+        }
+
+        if (leaf) continue;
+
+        // back to front so the first child is printed first
+        for (std::uint32_t n = node.mCount; n-- > 0; ) {
+            std::uint32_t kid = mKids[node.mFirst + n];
+
+            if (kid != None) todo.emplace_back(kid, depth + 1);
+        }
+    }
+}
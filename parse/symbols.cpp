@@ -78,91 +78,138 @@ SymbolTable methods
 */ 
 
 SymbolTable::SymbolTable() noexcept
-: mCurrentScope {nullptr} {
-	mCurrentScope = enterScope();
-    
-	auto id = createIdentifier("@@function");
+: mBindings {}
+, mUndo {}
+, mMarks {}
+, mFunction {nullptr}
+, mFunctions {}
+, mArena {} {
+	auto id = createIdentifier(Atoms::Function);
 	id->setType(Type::Function);
 
-	id = createIdentifier("@@variable");
+	id = createIdentifier(Atoms::Variable);
 	id->setType(Type::Int);
 
-	id = createIdentifier("printf");
+	id = createIdentifier(Atoms::Printf);
 	id->setType(Type::Function);
 }
 
-SymbolTable::~SymbolTable() noexcept {
-	delete mCurrentScope;
+SymbolTable::SymbolTable(const SymbolTable * table) noexcept
+: mBindings {table->mBindings}
+, mUndo {}
+, mMarks {}
+, mFunction {nullptr}
+, mFunctions {}
+, mArena {} {
+	// the globals of table w its @@ idents swapped for ones of our own
+	auto id = make(Atoms::Function);
+	id->setType(Type::Function);
+	bind(id);
+
+	id = make(Atoms::Variable);
+	id->setType(Type::Int);
+	bind(id);
 }
 
-bool SymbolTable::isDeclaredInScope(const std::string& s) const noexcept {
-    return mCurrentScope->searchInScope(s) != nullptr;
+bool SymbolTable::isDeclaredInScope(Atom name) const noexcept {
+    return getIdentifier(name) && mBindings[name].mDepth == mMarks.size();
 }
 
-Identifier * SymbolTable::createIdentifier(const std::string& s) noexcept {
-    if (isDeclaredInScope(s)) return nullptr;
+Identifier * SymbolTable::createIdentifier(Atom name) noexcept {
+    if (isDeclaredInScope(name)) return nullptr;
 
-    Identifier * ident = new Identifier(s);
-    mCurrentScope->addIdentifier(ident);
+    Identifier * ident = make(name);
+    bind(ident);
+
+    if (mFunction) mFunction->addIdentifier(mArena, ident);
 
     return ident;
 }
 
-Identifier * SymbolTable::getIdentifier(const std::string& s) const noexcept {
-    return mCurrentScope->search(s);
-}
+Identifier * SymbolTable::getIdentifier(std::string_view name) const noexcept {
+    Atom atom = Atoms::find(name);
 
-ScopeTable * SymbolTable::enterScope() noexcept {
-    return mCurrentScope = new ScopeTable(mCurrentScope);
+    // a name that was never interned cant have been declared
+    return atom != Atoms::None ? getIdentifier(atom) : nullptr;
 }
 
-void SymbolTable::exitScope() noexcept {
-    mCurrentScope = mCurrentScope->getParent();
+Identifier * SymbolTable::make(Atom name) noexcept {
+	// the constructor is private so the arena can only hand out the memory
+	return new (mArena.allocate(sizeof(Identifier), alignof(Identifier))) Identifier(name);
 }
 
-void SymbolTable::print(std::ostream& output) const noexcept {
-    output << "Symbols:\n";
+void SymbolTable::bind(Identifier * ident) noexcept {
+	Atom atom = ident->getAtom();
 
-	if (mCurrentScope) mCurrentScope->print(output);
-}
+	if (atom >= mBindings.size()) mBindings.resize(atom + 1, Binding {nullptr, 0});
 
-/*
-------------------------------------------------------
-ScopeTable methods
-*/ 
+	// the global scope is never left so there is nothing to undo there
+	if (!mMarks.empty()) mUndo.push_back({atom, mBindings[atom]});
 
-ScopeTable::ScopeTable(ScopeTable * parent) noexcept
-: mParent(parent) {
-    if (parent) parent->mChildren.emplace_back(this);
+	mBindings[atom] = {ident, mMarks.size()};
 }
 
-ScopeTable::~ScopeTable() noexcept {
-	for (auto t : mChildren) delete t;
+void SymbolTable::enterScope() noexcept {
+	mMarks.push_back(mUndo.size());
 }
 
-Identifier * ScopeTable::searchInScope(const std::string& name) noexcept {
-    std::unordered_map<std::string, Identifier *>::iterator iter = mSymbols.find(name);
+ScopeTable * SymbolTable::enterFunction() noexcept {
+	mFunction = mArena.make<ScopeTable>();
+	mFunctions.push_back(mFunction);
+
+	enterScope();
 
-    return iter != mSymbols.end() ? iter->second : nullptr;
+	return mFunction;
 }
 
-Identifier * ScopeTable::search(const std::string& name) noexcept {
-	Identifier * find = searchInScope(name);
+void SymbolTable::exitScope() noexcept {
+	std::size_t mark = mMarks.back();
 
-	if (find) return find;
-	if (mParent) return mParent->search(name);
-	
-    return nullptr;
+	// newest first so a name declared twice ends up w what it meant before the first
+	while (mUndo.size() > mark) {
+		const Undo& undo = mUndo.back();
+
+		mBindings[undo.mAtom] = undo.mShadowed;
+		mUndo.pop_back();
+	}
+
+	mMarks.pop_back();
+
+	// functions only nest in the global scope
+	if (mMarks.empty()) mFunction = nullptr;
 }
 
-void ScopeTable::addIdentifier(Identifier * ident) {
-    mSymbols.emplace(ident->getName(), ident);
+void SymbolTable::resumeFunction(ScopeTable * scope) noexcept {
+	enterScope();
+
+	// only the arguments are in it yet since a deferred body was never parsed
+	for (Identifier * ident : scope->getIdentifiers()) bind(ident);
+
+	mFunction = scope;
 }
 
+void SymbolTable::print(std::ostream& output) const noexcept {
+    output << "Symbols:\n";
+
+	ScopeTable globals;
+	Arena arena;
+
+	for (const Binding& binding : mBindings) {
+		if (binding.mIdent && binding.mDepth == 0) globals.addIdentifier(arena, binding.mIdent);
+	}
+
+	globals.print(output);
+
+	for (const ScopeTable * function : mFunctions) function->print(output, 1);
+}
+
+/*
+------------------------------------------------------
+ScopeTable methods
+*/ 
+
 void ScopeTable::print(std::ostream& output, int depth) const noexcept {
-    std::vector<Identifier*> idents;
-	
-    for (const auto& sym : mSymbols) idents.push_back(sym.second);
+    std::vector<Identifier*> idents {mIdents.begin(), mIdents.end()};
 
 	std::sort(idents.begin(), idents.end(), [](Identifier * a, Identifier * b) {
 		return a->getName() < b->getName();
@@ -208,24 +255,18 @@ void ScopeTable::print(std::ostream& output, int depth) const noexcept {
 		output << ident->getName();
 		output << '\n';
 	}
-
-	for (const auto& child : mChildren) {
-		child->print(output, depth + 1);
-	}
 }
 
 void ScopeTable::codegen(CodeContext& ctx) noexcept {
     // the only thing we should alloca are arrays of a specified size
-	// emit all the symbols in this scope
-	for (auto sym : mSymbols) {
-		Identifier * ident = sym.second;
-
+	// emit all the symbols of the function, the blocks they were declared in dont matter here
+	for (Identifier * ident : mIdents) {
         // build instructions for this function
 		llvm::IRBuilder<> build(ctx.mBlock);
 
 		llvm::Value * decl = nullptr;
 		
-		const std::string& name = ident->getName();
+		std::string_view name = ident->getName();
 		
 		// getArrayCount() is -1 if its an array thats passed into a function which we dont allocate it
 		if (ident->isArray() && ident->getArrayCount() != -1) {
@@ -251,11 +292,6 @@ void ScopeTable::codegen(CodeContext& ctx) noexcept {
 			ident->writeTo(ctx, decl);
 		}
 	}
-	
-	// emit all the variables in the child scopes
-	for (auto table : mChildren) {
-		table->codegen(ctx);
-	}
 }
 
 /*
@@ -263,49 +299,80 @@ void ScopeTable::codegen(CodeContext& ctx) noexcept {
 StringTable methods
 */ 
 
-// delete all allocated ConstStr * using new
-StringTable::~StringTable() noexcept {
-	for (auto i : mStrings) {
-		delete i.second;
-	}
-}
+std::vector<ConstStr *> StringTable::getOrdered() noexcept {
+	std::vector<ConstStr *> strs;
+	strs.reserve(getCount());
 
-// looks up the requested string in the string table
-// if it exists returns the corresponding ConstStr
-// otherwise constructs a new ConstStr and returns that
-ConstStr * StringTable::getString(const std::string& val) noexcept {
-	std::unordered_map<std::string, ConstStr *>::iterator iter = mStrings.find(val);
-
-	if (iter != mStrings.end()) {
-		return iter->second;
-	} else {
-        // result is a pair where first is an iterator to the element and second is a boolean
-        auto result = mStrings.emplace(val, new ConstStr(val));
-        
-        // iterator to the key value pair
-        auto it = result.first;
-
-        // pointer to value in pair
-		return it->second;
-	}
+	for (std::size_t i = 0; i < getCount(); ++i) strs.push_back(&mStrings.value(i));
+
+	// no two literals start at the same offset so this is a total order
+	std::sort(strs.begin(), strs.end(), [](const ConstStr * a, const ConstStr * b) {
+		return a->getFirstUse() < b->getFirstUse();
+	});
+
+	return strs;
 }
 
 void StringTable::codegen(CodeContext& ctx) noexcept {
-	for (const auto& s : mStrings) {
-		ConstStr * str = s.second;
-		
-        // make the value 
-		llvm::Constant * strVal = llvm::ConstantDataArray::getString(*ctx.mGlobalContext, str->mText);
-		
-        // make the type
-		llvm::ArrayType * type = llvm::ArrayType::get(llvm::Type::getInt8Ty(*ctx.mGlobalContext), str->mText.size() + 1);
+	std::vector<ConstStr *> strs = getOrdered();
 
-        // create global var using strVal and type
-		llvm::GlobalValue * globVal = new llvm::GlobalVariable(*ctx.mModule, type, true, llvm::GlobalValue::LinkageTypes::PrivateLinkage, strVal, ".str");
+	// sorted by their reversed text every string that ends w another one comes right after it, so the string a
+	// string is the tail of (if any) is the next one and the longest one of a run holds all of them
+	std::vector<std::size_t> tails(strs.size());
+	std::vector<std::size_t> host(strs.size());
 
-		// this can be "unnamed" since the address location is not significant
-		globVal->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
-		
-		str->mValue = globVal;
+	for (std::size_t i = 0; i < strs.size(); ++i) tails[i] = i;
+
+	std::sort(tails.begin(), tails.end(), [&](std::size_t a, std::size_t b) {
+		std::string_view x = strs[a]->mText, y = strs[b]->mText;
+
+		return std::lexicographical_compare(x.rbegin(), x.rend(), y.rbegin(), y.rend());
+	});
+
+	for (std::size_t i = tails.size(); i-- > 0;) {
+		std::size_t at = tails[i];
+		host[at] = at;
+
+		if (i + 1 < tails.size()) {
+			std::string_view text = strs[at]->mText, next = strs[tails[i + 1]]->mText;
+
+			if (next.size() > text.size() && next.compare(next.size() - text.size(), text.size(), text) == 0) {
+				host[at] = host[tails[i + 1]];
+			}
+		}
+	}
+
+	llvm::Type * i8 = llvm::Type::getInt8Ty(*ctx.mGlobalContext);
+	llvm::Type * i32 = llvm::Type::getInt32Ty(*ctx.mGlobalContext);
+
+	// a host is emitted when the first string it holds is reached so the globals come in first use order
+	for (std::size_t i = 0; i < strs.size(); ++i) {
+		ConstStr * str = strs[i];
+		ConstStr * owner = strs[host[i]];
+
+		if (!owner->mValue) {
+			// make the value 
+			llvm::Constant * strVal = llvm::ConstantDataArray::getString(*ctx.mGlobalContext, owner->mText);
+			
+			// make the type
+			llvm::ArrayType * type = llvm::ArrayType::get(i8, owner->mText.size() + 1);
+
+			// create global var using strVal and type
+			llvm::GlobalValue * globVal = new llvm::GlobalVariable(*ctx.mModule, type, true, llvm::GlobalValue::LinkageTypes::PrivateLinkage, strVal, ".str");
+
+			// this can be "unnamed" since the address location is not significant
+			globVal->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+			
+			owner->mValue = globVal;
+		}
+
+		if (str == owner) continue;
+
+		// a tail is the address of its first char in the host, cast to its own array type so uses see no difference
+		llvm::GlobalVariable * globVal = llvm::cast<llvm::GlobalVariable>(owner->mValue);
+		llvm::Constant * idx[] = {llvm::ConstantInt::get(i32, 0), llvm::ConstantInt::get(i32, owner->mText.size() - str->mText.size())};
+		llvm::Constant * tail = llvm::ConstantExpr::getInBoundsGetElementPtr(globVal->getValueType(), globVal, idx);
+
+		str->mValue = llvm::ConstantExpr::getBitCast(tail, llvm::ArrayType::get(i8, str->mText.size() + 1)->getPointerTo());
 	}
 }
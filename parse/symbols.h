@@ -5,10 +5,16 @@ defines the classes needed to perform semantic analysis i.e. class Identifier, S
 #ifndef SYMBOLS_H
 #define SYMBOLS_H
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
-#include <unordered_map>
+#include "../scan/atoms.h"
+#include "../scan/interner.h"
+#include "arena.h"
 #include "types.h"
 
 // in ../parse/astNodes.h
@@ -28,10 +34,13 @@ class Identifier {
 public:
     friend class SymbolTable;
 
+    // a cached AST brings its own identifiers (see astCache.h)
+    friend class ASTCache;
+
     ~Identifier() noexcept = default;
 
     bool isDummy() const noexcept {
-		return mName == "@@variable" || mName == "@@function";
+		return mAtom == Atoms::Variable || mAtom == Atoms::Function;
 	}
 
     bool isArray() const noexcept {
@@ -52,7 +61,7 @@ public:
         mElemCount = count;
     }
 
-    void setFunction(std::shared_ptr<ASTFunc> func) noexcept {
+    void setFunction(ASTFunc * func) noexcept {
         mFunction = func;
     }
 
@@ -60,10 +69,14 @@ public:
 		mAddress = value;
 	}
 
-    const std::string& getName() const noexcept {
+    std::string_view getName() const noexcept {
         return mName;
     }
 
+    Atom getAtom() const noexcept {
+        return mAtom;
+    }
+
     Type getType() const noexcept {
         return mType;
     }
@@ -72,7 +85,7 @@ public:
         return mElemCount;
     }
     
-    std::shared_ptr<ASTFunc> getFunction() const noexcept {
+    ASTFunc * getFunction() const noexcept {
         return mFunction;
     }
     
@@ -87,18 +100,23 @@ public:
 	void writeTo(CodeContext& ctx, llvm::Value * value) noexcept;
 private:
     // private so only SymbolTable can create Identifier
-    Identifier(const std::string& name) noexcept
-    : mName {name}
+    // nothing in it owns memory so the identifiers can live in an arena
+    Identifier(Atom atom) noexcept
+    : mName {Atoms::spelling(atom)}
+    , mAtom {atom}
     , mFunction {nullptr}
     , mType {Type::Void}
     , mElemCount {-1} 
     , mAddress {nullptr} { }
 
-    // name of ident
-    std::string mName;
+    // name of ident, the spelling of mAtom
+    std::string_view mName;
+
+    // interned name, what the scopes are keyed on
+    Atom mAtom;
 
     // pointer to function of ident
-    std::shared_ptr<ASTFunc> mFunction;
+    ASTFunc * mFunction = nullptr;
 
     // type of ident
     Type mType;
@@ -110,25 +128,26 @@ private:
     llvm::Value * mAddress;
 };
 
-// recursive as scope is nested
+static_assert(std::is_trivially_destructible<Identifier>::value, "identifiers live in an arena that never runs destructors");
+
+// the identifiers a function declares i.e. its arguments and the locals of every block in its body in the order they
+// were declared. the blocks themselves only exist while they are parsed (see SymbolTable) so codegen, which front
+// loads the stack slots of a function, walks this one list instead of a tree of scopes
 class ScopeTable {
 public:
-    // set new ScopeTable to SymbolTable member and add to parent ScopeTable if needed
-    ScopeTable(ScopeTable * parent) noexcept;
+    ScopeTable() noexcept = default;
 
-    // delete all children scope tables
-    ~ScopeTable() noexcept;
+    // everything is in the arena of the SymbolTable that declared it
+    ~ScopeTable() noexcept = default;
     
     // adds the requested identifier to the table
-    void addIdentifier(Identifier * ident);
-    
-    // searches this scope for an identifier with
-    // the requested name and returns nullptr if not found
-    Identifier * searchInScope(const std::string& name) noexcept;
-    
-    // searches this scope first and if not found searches
-    // through parent scopes and if not found return nullptr 
-    Identifier * search(const std::string& name) noexcept;
+    void addIdentifier(Arena& arena, Identifier * ident) noexcept {
+        mIdents.push_back(arena, ident);
+    }
+
+    const ArenaVector<Identifier *>& getIdentifiers() const noexcept {
+        return mIdents;
+    }
     
     // prints the scope table to the specified stream
     void print(std::ostream& output, int depth = 0) const noexcept;
@@ -136,50 +155,93 @@ public:
     // emits declarations for all non-function symbols in this scope
     // used to front-load all stack-based variables to the start of the function
 	void codegen(CodeContext& context) noexcept;
-
-    ScopeTable * getParent() {
-        return mParent;
-    }
 private:
-    // hash table contains all the identifiers in this scope
-    std::unordered_map<std::string, Identifier *> mSymbols;
-    
-    // vector of the child tables
-    std::vector<ScopeTable *> mChildren;
-    
-    // Points to parent ScopeTable
-    ScopeTable * mParent;
+    ArenaVector<Identifier *> mIdents;
 };
 
-// store member as ScopeTable to exit and leave scopes
+// scopes are kept flat: each name maps straight to what it means right now and every declaration logs what it
+// shadowed, so leaving a scope undoes its declarations and a lookup is one array index no matter how deep the
+// blocks nest. the identifiers and function scopes are allocated in an arena that lives as long as the table
 class SymbolTable {
 public:
     // enter global scope and add dummy function and variable idents also add printf ident 
     SymbolTable() noexcept;
 
-    // delete mCurrentScope which calls delete on all its children etc etc
-    ~SymbolTable() noexcept;
+    // a view for a parser on another thread that starts out w the global scope of table (see resumeFunction),
+    // it only owns a @@function and @@variable of its own since the parse writes to those
+    explicit SymbolTable(const SymbolTable * table) noexcept;
+
+    ~SymbolTable() noexcept = default;
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
 
     // returns true if declared in this scope
-    bool isDeclaredInScope(const std::string& s) const noexcept;
+    bool isDeclaredInScope(Atom name) const noexcept;
 
     // creates the requested identifier and returns a pointer to it
     // if the identifier already exists it returns nullptr
-    Identifier * createIdentifier(const std::string& s) noexcept;
+    Identifier * createIdentifier(Atom name) noexcept;
     
     // returns a pointer to the identifier if found otherwise returns nullptr
-    Identifier * getIdentifier(const std::string& s) const noexcept;
+    Identifier * getIdentifier(Atom name) const noexcept {
+        return name < mBindings.size() ? mBindings[name].mIdent : nullptr;
+    }
+
+    // same for a name that did not come from a token e.g. an export list, w/o interning it
+    Identifier * getIdentifier(std::string_view name) const noexcept;
     
-    // enters a new scope and returns a pointer to this scope table
-    ScopeTable * enterScope() noexcept;
+    // enters a new block scope
+    void enterScope() noexcept;
+
+    // enters the scope of a new function, its arguments and the locals of its body are added to the returned table
+    ScopeTable * enterFunction() noexcept;
     
-    // exits the current scope and moves the current scope back to the previous scope table
+    // exits the current scope, the names it declared mean again what they did before it
     void exitScope() noexcept;
 
+    // enters the scope of a function declared by another table w its arguments back in it e.g. one whose body is
+    // parsed later on another thread, left w exitScope like any other
+    void resumeFunction(ScopeTable * scope) noexcept;
+
     // prints the symbol table to the specified stream
     void print(std::ostream& output) const noexcept;
 private:
-    ScopeTable * mCurrentScope; 
+    // what a name means and the scope depth it was declared at (0 is the global scope)
+    struct Binding {
+        Identifier * mIdent;
+        std::size_t mDepth;
+    };
+
+    // a declaration in one of the open scopes and the binding it shadowed
+    struct Undo {
+        Atom mAtom;
+        Binding mShadowed;
+    };
+
+    // a new identifier in mArena
+    Identifier * make(Atom name) noexcept;
+
+    // make ident what its name means in the current scope
+    void bind(Identifier * ident) noexcept;
+
+    // binding of each atom indexed by atom, atoms are global so it is grown as new ones are declared
+    std::vector<Binding> mBindings;
+
+    // declarations of the open scopes other than the global one, innermost last
+    std::vector<Undo> mUndo;
+
+    // size of mUndo when each open scope was entered
+    std::vector<std::size_t> mMarks;
+
+    // the function being declared into, nullptr at global scope
+    ScopeTable * mFunction;
+
+    // every function scope in the order they were entered (for print)
+    std::vector<ScopeTable *> mFunctions;
+
+    // identifiers and function scopes
+    Arena mArena;
 };
 
 // used to store/reference constant strings
@@ -187,41 +249,73 @@ class ConstStr {
 public:
 	friend class StringTable;
 
-	ConstStr(const std::string& text) noexcept
+	// text is the copy interned by the StringTable
+	ConstStr(std::string_view text) noexcept
 	: mText {text} 
-    , mValue {nullptr} {}
+    , mValue {nullptr}
+    , mFirstUse {SIZE_MAX} {}
 
     ~ConstStr() noexcept = default;
 	
-	const std::string& getText() const noexcept {
+	std::string_view getText() const noexcept {
 		return mText;
 	}
 
     llvm::Value* getValue() const noexcept {
 		return mValue;
 	}
+
+    // source offset of the first literal w this text
+    std::size_t getFirstUse() const noexcept {
+        return mFirstUse.load(std::memory_order_relaxed);
+    }
 private:
-	std::string mText;
+    // keep the smallest offset seen, bodies parsed on several threads can use the same string at once
+    void use(std::size_t offset) noexcept {
+        std::size_t first = mFirstUse.load(std::memory_order_relaxed);
+
+        while (offset < first && !mFirstUse.compare_exchange_weak(first, offset, std::memory_order_relaxed));
+    }
+
+	std::string_view mText;
 
     llvm::Value * mValue;
+
+    std::atomic<std::size_t> mFirstUse;
 };
 
 class StringTable {
 public:
 	StringTable() noexcept = default;
 
-    // free all ConstStr instances allocated
-	~StringTable() noexcept;
+	~StringTable() noexcept = default;
 	
 	// looks up the requested string in mStrings
 	// if it exists returns the corresponding ConstStr
 	// otherwise constructs a new ConstStr and returns that
-	ConstStr * getString(const std::string& val) noexcept;
+	// offset is where in the source the literal is, the strings are emitted in the order of their first use
+	ConstStr * getString(std::string_view val, std::size_t offset) noexcept {
+		ConstStr * str = &mStrings.value(mStrings.intern(val));
+
+		str->use(offset);
+
+		return str;
+	}
+
+    // number of strings
+    std::size_t getCount() const noexcept {
+        return mStrings.size();
+    }
+
+    // the strings in the order they are first used in the source, the same however many threads parsed it
+    std::vector<ConstStr *> getOrdered() noexcept;
 
-    // emit the table to the IR constants
+    // emit the table to the IR constants, a string that is the tail of another one points into its global
     void codegen(CodeContext& ctx) noexcept;
 private:
-	std::unordered_map<std::string, ConstStr *> mStrings;
+	// function bodies parsed on several threads add to the table at once so the ids are in no set order, a cached AST
+	// adds the strings back w their index in the cache as the first use
+	Interner<ConstStr> mStrings;
 };
 
 #endif
\ No newline at end of file
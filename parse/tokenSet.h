@@ -0,0 +1,93 @@
+/*
+defines a constant set of token types i.e. class TokenSet and the FIRST/FOLLOW sets of the grammar rules i.e. class Grammar
+
+a TokenSet is a single 64 bit mask w one bit per TokenType so sets are built at compile time and a membership test
+is one shift + AND, the parser uses them for all of its lookahead checks and for error recovery
+*/
+
+#ifndef TOKENSET_H
+#define TOKENSET_H
+
+#include <cstdint>
+#include <initializer_list>
+#include "../scan/token.h"
+
+class TokenSet {
+public:
+	static_assert(static_cast<unsigned>(TokenType::EndOfFile) < 64, "TokenSet holds one bit per TokenType in 64 bits");
+
+	constexpr TokenSet() noexcept
+	: mBits {0} { }
+
+	constexpr TokenSet(std::initializer_list<TokenType> types) noexcept
+	: mBits {0} {
+		for (TokenType type : types) mBits |= bit(type);
+	}
+
+	constexpr bool contains(TokenType type) const noexcept {
+		return (mBits & bit(type)) != 0;
+	}
+
+	constexpr TokenSet operator|(TokenSet other) const noexcept {
+		TokenSet retVal;
+		retVal.mBits = mBits | other.mBits;
+		return retVal;
+	}
+private:
+	std::uint64_t mBits;
+
+	static constexpr std::uint64_t bit(TokenType type) noexcept {
+		return std::uint64_t {1} << static_cast<unsigned>(type);
+	}
+};
+
+class Grammar {
+public:
+	// FIRST sets i.e. the tokens each rule can start w
+
+	// type specifiers that start a function definition
+	static constexpr TokenSet FirstFunction {TokenType::KeyVoid, TokenType::KeyDouble, TokenType::KeyInt, TokenType::KeyChar};
+
+	// type specifiers that start a variable or argument declaration
+	static constexpr TokenSet FirstDecl {TokenType::KeyChar, TokenType::KeyDouble, TokenType::KeyInt};
+
+	static constexpr TokenSet FirstFactor {
+		TokenType::LParen, TokenType::IntLit, TokenType::StringLit, TokenType::CharLit, TokenType::DoubleLit,
+		TokenType::Identifier, TokenType::Inc, TokenType::Dec, TokenType::Addr
+	};
+
+	// every level of an expression starts w a value i.e. an optional ! and a factor
+	static constexpr TokenSet FirstExpr = FirstFactor | TokenSet {TokenType::Not};
+
+	static constexpr TokenSet FirstStmt = FirstExpr | FirstDecl | TokenSet {
+		TokenType::LBrace, TokenType::KeyFor, TokenType::KeyReturn, TokenType::KeyWhile, TokenType::KeyIf, TokenType::SemiColon
+	};
+
+	// operators of each precedence level of the recursive descent expression chain
+	static constexpr TokenSet AssignOps {TokenType::Assign, TokenType::DecAssign, TokenType::IncAssign};
+	static constexpr TokenSet RelOps {
+		TokenType::EqualTo, TokenType::NotEqual, TokenType::LessThan, TokenType::GreaterThan, TokenType::LThanOrEq, TokenType::GThanOrEq
+	};
+	static constexpr TokenSet AddOps {TokenType::Plus, TokenType::Minus};
+	static constexpr TokenSet MulOps {TokenType::Mult, TokenType::Div, TokenType::Mod};
+
+	// FOLLOW sets i.e. the tokens that can come right after each rule, the parser resyncs on these after a syntax error
+
+	// FOLLOW(stmt) is FIRST(stmt) + } else EOF but the FIRST(expr) part is left out, those tokens also turn up in the
+	// middle of the broken statement and resyncing there would just break again
+	static constexpr TokenSet FollowStmt = FirstDecl | TokenSet {
+		TokenType::SemiColon, TokenType::LBrace, TokenType::RBrace, TokenType::KeyFor, TokenType::KeyReturn,
+		TokenType::KeyWhile, TokenType::KeyIf, TokenType::KeyElse
+	};
+
+	// the argument list is followed by its ) and then the body, the { is in here so a missing ) does not eat the body
+	static constexpr TokenSet FollowArgList {TokenType::RParen, TokenType::LBrace};
+
+	static constexpr TokenSet FollowFunction = FirstFunction | TokenSet {TokenType::EndOfFile};
+
+	// bracket pairs, used to skip over a whole nested construct
+	static constexpr TokenSet OpenBrackets {TokenType::LParen, TokenType::LBracket, TokenType::LBrace};
+	static constexpr TokenSet CloseBrackets {TokenType::RParen, TokenType::RBracket, TokenType::RBrace};
+};
+
+#endif
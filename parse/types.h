@@ -5,7 +5,10 @@ defines the valid types for our language
 #ifndef TYPES_H
 #define TYPES_H
 
-enum class Type {
+#include <cstdint>
+
+// one byte so it packs in next to the NodeKind of an ASTExpr (see astNodes.h)
+enum class Type : std::uint8_t {
 	Void,
 	Int,
 	Char,
@@ -0,0 +1,36 @@
+#include "interner.h"
+#include "atoms.h"
+
+namespace {
+
+// built on first use so tokens made during static init (if any) find it ready
+Interner<>& table() noexcept {
+    static Interner<>& sTable = []() -> Interner<>& {
+        static Interner<> table;
+
+        // in the order of the fixed atoms in atoms.h
+        for (std::string_view name : {"@@function", "@@variable", "printf", "main"}) table.intern(name);
+
+        return table;
+    }();
+
+    return sTable;
+}
+
+}
+
+Atom Atoms::intern(std::string_view text) noexcept {
+    return table().intern(text);
+}
+
+Atom Atoms::find(std::string_view text) noexcept {
+    return table().find(text);
+}
+
+std::string_view Atoms::spelling(Atom atom) noexcept {
+    return table().text(atom);
+}
+
+std::size_t Atoms::size() noexcept {
+    return table().size();
+}
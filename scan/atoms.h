@@ -0,0 +1,48 @@
+/*
+defines the identifier interner i.e. class Atoms which turns each identifier spelling into a 32 bit atom
+
+the scanner interns the spelling of every identifier token it hands out (see Token) so the parser and the symbol
+tables key on atoms and a name is compared by an integer compare instead of being rehashed at every scope it is
+looked up in. the table is global, an atom stands for the same spelling for as long as the process runs so tokens
+of several scanners (or of bodies parsed on several threads) can be compared directly
+
+atoms are handed out densely from 0 in the order spellings are first seen, the names the compiler looks up itself
+are interned up front so they have fixed atoms
+*/
+
+#ifndef ATOMS_H
+#define ATOMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using Atom = std::uint32_t;
+
+class Atoms {
+public:
+    // dummy idents a declaration or use that failed resolves to so the parse can go on (see SymbolTable)
+    static constexpr Atom Function = 0;
+    static constexpr Atom Variable = 1;
+
+    // names w a meaning of their own
+    static constexpr Atom Printf = 2;
+    static constexpr Atom Main = 3;
+
+    // atom of no spelling
+    static constexpr Atom None = UINT32_MAX;
+
+    // atom of text, text is copied in if it has not been seen before
+    static Atom intern(std::string_view text) noexcept;
+
+    // atom of text if it has been interned otherwise None, never adds anything
+    static Atom find(std::string_view text) noexcept;
+
+    // text of an interned atom, valid for as long as the process runs
+    static std::string_view spelling(Atom atom) noexcept;
+
+    // number of atoms handed out so far
+    static std::size_t size() noexcept;
+};
+
+#endif
@@ -0,0 +1,61 @@
+/*
+defines a lookup table character classifier so the scanner never calls into libc ctype (which goes through the locale)
+
+only ASCII is classified, bytes >= 128 are never whitespace/digits/identifier chars
+*/
+
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+#include <array>
+#include <cstdint>
+
+class CharClass {
+public:
+    // bits stored per byte in the table
+    enum : std::uint8_t {
+        Space = 1 << 0, // ' ', '\t', '\n'
+        Digit = 1 << 1, // [0-9]
+        Alpha = 1 << 2, // [a-zA-Z]
+        Under = 1 << 3  // _
+    };
+
+    static bool isSpace(char c) noexcept {
+        return sTable[static_cast<unsigned char>(c)] & Space;
+    }
+
+    static bool isDigit(char c) noexcept {
+        return sTable[static_cast<unsigned char>(c)] & Digit;
+    }
+
+    // [a-zA-Z_]
+    static bool isIdentStart(char c) noexcept {
+        return sTable[static_cast<unsigned char>(c)] & (Alpha | Under);
+    }
+
+    // [a-zA-Z0-9_]
+    static bool isIdentChar(char c) noexcept {
+        return sTable[static_cast<unsigned char>(c)] & (Alpha | Under | Digit);
+    }
+private:
+    static constexpr std::array<std::uint8_t, 256> makeTable() noexcept {
+        std::array<std::uint8_t, 256> table {};
+
+        table[' '] = table['\t'] = table['\n'] = Space;
+
+        for (int c = '0'; c <= '9'; ++c) table[c] = Digit;
+        for (int c = 'a'; c <= 'z'; ++c) table[c] = Alpha;
+        for (int c = 'A'; c <= 'Z'; ++c) table[c] = Alpha;
+
+        table['_'] = Under;
+
+        return table;
+    }
+
+    // one entry per byte value, defined below once the class is complete
+    static const std::array<std::uint8_t, 256> sTable;
+};
+
+inline constexpr std::array<std::uint8_t, 256> CharClass::sTable = CharClass::makeTable();
+
+#endif
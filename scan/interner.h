@@ -0,0 +1,286 @@
+/*
+defines class Interner, a string table that hands out a dense 32 bit id per distinct string and can be used from any
+number of threads at once w/o a global lock
+
+ids are handed out from 0 in the order strings are first added and never change. each id comes w a T made from the
+interned copy of its string when it is added (Atoms only needs the id, StringTable keeps a ConstStr per literal) so
+whatever is made per string is published together w its id
+
+the table is split into shards by the high bits of the hash, each an open addressing table of 64 bit slots that hold
+the low 32 bits of the hash and the id:
+    lookups take no lock at all, they load the shards table and probe it w atomic loads
+    an insert locks only its shard, writes the entry and then publishes it w a release store of its slot
+    a shard grows by building a table twice the size and swapping it in, the old one stays until the interner is
+    destroyed so a lookup that is still probing it is never left w freed memory (it just may not see the newest ids
+    and the insert path looks again under the lock)
+the text is copied into blocks that never move and the entries live in chunks of doubling size so neither the text
+nor a T ever moves once its id is out
+*/
+
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <vector>
+
+// the T of an interner that only hands out ids
+struct NoValue {
+    explicit NoValue(std::string_view) noexcept { }
+};
+
+template <typename T = NoValue>
+class Interner {
+public:
+    // id of no string
+    static constexpr std::uint32_t None = UINT32_MAX;
+
+    Interner() noexcept
+    : mCount {0} {
+        for (Shard& shard : mShards) shard.grow();
+        for (std::atomic<Entry *>& chunk : mChunks) chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~Interner() noexcept {
+        std::uint32_t count = mCount.load(std::memory_order_acquire);
+
+        for (std::uint32_t id = 0; id < count; ++id) entry(id).mValue.~T();
+
+        for (std::size_t k = 0; k < Chunks; ++k) ::operator delete(mChunks[k].load(std::memory_order_relaxed));
+    }
+
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+    // id of text, text is copied in and its T made if it has not been seen before
+    std::uint32_t intern(std::string_view text) noexcept {
+        std::size_t h = hash(text);
+        Shard& shard = mShards[h >> ShardShift];
+
+        std::uint32_t id = probe(*shard.mTable.load(std::memory_order_acquire), text, h);
+
+        if (id != None) return id;
+
+        std::lock_guard<std::mutex> lock {shard.mLock};
+
+        // another thread may have added it or grown the table in between
+        id = probe(*shard.mTable.load(std::memory_order_relaxed), text, h);
+
+        return id != None ? id : insert(shard, text, h);
+    }
+
+    // id of text if it has been interned otherwise None, never adds anything
+    std::uint32_t find(std::string_view text) const noexcept {
+        std::size_t h = hash(text);
+
+        return probe(*mShards[h >> ShardShift].mTable.load(std::memory_order_acquire), text, h);
+    }
+
+    // interned copy of the string of an id handed out by intern/find
+    std::string_view text(std::uint32_t id) const noexcept {
+        return entry(id).mText;
+    }
+
+    T& value(std::uint32_t id) noexcept {
+        return entry(id).mValue;
+    }
+
+    const T& value(std::uint32_t id) const noexcept {
+        return entry(id).mValue;
+    }
+
+    // number of ids handed out, once no thread is adding any more the ids are [0, size())
+    std::size_t size() const noexcept {
+        return mCount.load(std::memory_order_acquire);
+    }
+private:
+    // 64 shards picked by the top 6 bits of the hash
+    static constexpr std::size_t ShardShift = 58;
+    static constexpr std::size_t Shards = 64;
+
+    // first table size of a shard (power of 2)
+    static constexpr std::size_t MinSlots = 64;
+
+    // text is copied into blocks of this many bytes (longer strings get a block of their own)
+    static constexpr std::size_t BlockSize = 1 << 14;
+
+    // chunk k of the entries holds FirstChunk << k of them, enough chunks for every 32 bit id
+    static constexpr std::size_t FirstChunkBits = 10;
+    static constexpr std::size_t Chunks = 33 - FirstChunkBits;
+
+    struct Entry {
+        std::string_view mText;
+        T mValue;
+    };
+
+    // slot = low 32 bits of the hash << 32 | id + 1, 0 is an empty slot
+    struct Table {
+        explicit Table(std::size_t size) noexcept
+        : mMask {size - 1}
+        , mSlots {new std::atomic<std::uint64_t>[size]} {
+            for (std::size_t i = 0; i < size; ++i) mSlots[i].store(0, std::memory_order_relaxed);
+        }
+
+        std::size_t mMask;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> mSlots;
+    };
+
+    // own cache line each so the locks of two shards dont bounce the same line between cores
+    struct alignas(64) Shard {
+        Shard() noexcept
+        : mTable {nullptr}
+        , mUsed {0}
+        , mBlock {nullptr}
+        , mBlockUsed {BlockSize} { }
+
+        // swap in a table twice the size (or the first one), caller holds mLock
+        void grow() noexcept {
+            Table * old = mTable.load(std::memory_order_relaxed);
+
+            mTables.emplace_back(new Table(old ? 2 * (old->mMask + 1) : MinSlots));
+
+            Table * table = mTables.back().get();
+
+            if (old) {
+                for (std::size_t i = 0; i <= old->mMask; ++i) {
+                    std::uint64_t slot = old->mSlots[i].load(std::memory_order_relaxed);
+
+                    if (slot) place(*table, slot);
+                }
+            }
+
+            // the slots are all written before a lookup can see the table
+            mTable.store(table, std::memory_order_release);
+        }
+
+        // slot in the first free place of its probe sequence, caller holds mLock
+        static void place(Table& table, std::uint64_t slot) noexcept {
+            std::size_t i = (slot >> 32) & table.mMask;
+
+            while (table.mSlots[i].load(std::memory_order_relaxed)) i = (i + 1) & table.mMask;
+
+            table.mSlots[i].store(slot, std::memory_order_release);
+        }
+
+        // stable copy of text, caller holds mLock
+        std::string_view copy(std::string_view text) noexcept {
+            char * at;
+
+            if (text.size() > BlockSize) {
+                mBlocks.emplace_back(new char[text.size()]);
+                at = mBlocks.back().get();
+            } else {
+                if (!mBlock || mBlockUsed + text.size() > BlockSize) {
+                    mBlocks.emplace_back(new char[BlockSize]);
+                    mBlock = mBlocks.back().get();
+                    mBlockUsed = 0;
+                }
+
+                at = mBlock + mBlockUsed;
+                mBlockUsed += text.size();
+            }
+
+            std::copy(text.begin(), text.end(), at);
+
+            return {at, text.size()};
+        }
+
+        // table lookups probe, the current one is the last of mTables
+        std::atomic<Table *> mTable;
+
+        // number of slots used
+        std::size_t mUsed;
+
+        std::mutex mLock;
+
+        // every table this shard had, the old ones only for lookups that may still be probing them
+        std::vector<std::unique_ptr<Table>> mTables;
+
+        std::vector<std::unique_ptr<char[]>> mBlocks;
+
+        // block being filled and the bytes used of it
+        char * mBlock;
+        std::size_t mBlockUsed;
+    };
+
+    static std::size_t hash(std::string_view text) noexcept {
+        return std::hash<std::string_view> {}(text);
+    }
+
+    // chunk and index in it of an id
+    static std::size_t chunkOf(std::uint32_t id, std::size_t& index) noexcept {
+        std::uint64_t v = std::uint64_t {id} + (std::uint64_t {1} << FirstChunkBits);
+        std::size_t bit = 63 - __builtin_clzll(v);
+
+        index = v - (std::uint64_t {1} << bit);
+
+        return bit - FirstChunkBits;
+    }
+
+    Entry& entry(std::uint32_t id) const noexcept {
+        std::size_t index;
+        std::size_t k = chunkOf(id, index);
+
+        // whoever got the id from a slot or from insert has seen the chunk pointer stored before it
+        return mChunks[k].load(std::memory_order_relaxed)[index];
+    }
+
+    std::uint32_t probe(const Table& table, std::string_view text, std::size_t h) const noexcept {
+        std::uint64_t tag = h & 0xffffffff;
+
+        for (std::size_t i = h & table.mMask;; i = (i + 1) & table.mMask) {
+            // acquire so the entry written before the slot is seen
+            std::uint64_t slot = table.mSlots[i].load(std::memory_order_acquire);
+
+            if (!slot) return None;
+
+            std::uint32_t id = static_cast<std::uint32_t>(slot) - 1;
+
+            if ((slot >> 32) == tag && entry(id).mText == text) return id;
+        }
+    }
+
+    // add text to shard and return its new id, caller holds the shards lock and has checked text is not in it
+    std::uint32_t insert(Shard& shard, std::string_view text, std::size_t h) noexcept {
+        // kept at most half full so probes stay short
+        if (2 * (shard.mUsed + 1) > shard.mTable.load(std::memory_order_relaxed)->mMask + 1) shard.grow();
+
+        std::uint32_t id = mCount.fetch_add(1, std::memory_order_relaxed);
+        std::size_t index;
+        std::size_t k = chunkOf(id, index);
+        Entry * chunk = mChunks[k].load(std::memory_order_acquire);
+
+        if (!chunk) {
+            // the first id in a chunk can be handed out in more than one shard at once, one of them gets to add it
+            Entry * fresh = static_cast<Entry *>(::operator new(sizeof(Entry) << (k + FirstChunkBits)));
+
+            if (mChunks[k].compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) chunk = fresh;
+            else ::operator delete(fresh);
+        }
+
+        std::string_view copy = shard.copy(text);
+
+        new (&chunk[index]) Entry {copy, T(copy)};
+
+        ++shard.mUsed;
+        Shard::place(*shard.mTable.load(std::memory_order_relaxed), (std::uint64_t {h & 0xffffffff} << 32) | (std::uint64_t {id} + 1));
+
+        return id;
+    }
+
+    Shard mShards[Shards];
+
+    // entries by id, chunk k holds ids [(2^k - 1) << FirstChunkBits, (2^(k + 1) - 1) << FirstChunkBits)
+    std::atomic<Entry *> mChunks[Chunks];
+
+    std::atomic<std::uint32_t> mCount;
+};
+
+#endif
@@ -0,0 +1,52 @@
+/*
+defines class LineTable which records the source offset each line starts at as the scanner passes the newlines
+
+lines and columns of a token are then found w a binary search over the starts instead of being tracked per character
+*/
+
+#ifndef LINETABLE_H
+#define LINETABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class LineTable {
+public:
+    // line 1 starts at offset 0
+    LineTable() noexcept
+    : mStarts {0} { }
+
+    ~LineTable() noexcept = default;
+
+    // a new line starts at offset (the char after a newline)
+    void add(std::size_t offset) noexcept {
+        mStarts.push_back(offset);
+    }
+
+    // number of lines seen so far
+    std::size_t size() const noexcept {
+        return mStarts.size();
+    }
+
+    // 1 based line the offset is on
+    std::int64_t line(std::size_t offset) const noexcept {
+        return std::upper_bound(mStarts.begin(), mStarts.end(), offset) - mStarts.begin();
+    }
+
+    // 1 based column of offset on its line
+    std::int64_t col(std::size_t offset) const noexcept {
+        return offset - mStarts[line(offset) - 1] + 1;
+    }
+
+    // offset line (1 based) starts at
+    std::size_t start(std::int64_t line) const noexcept {
+        return mStarts[line - 1];
+    }
+private:
+    // offset of the first char of each line in order
+    std::vector<std::size_t> mStarts;
+};
+
+#endif
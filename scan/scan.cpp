@@ -1,44 +1,59 @@
-#include <fstream> 
-#include <sstream> 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <utility> 
-#include <cctype> 
 #include <iostream>
+#include "charClass.h"
+#include "simdScan.h"
 #include "scan.h"
 
-Scanner::Scanner(const char * src) noexcept
-: mSource {}
-, mKeywords {
-    {"for", TokenType::KeyFor},
-    {"while", TokenType::KeyWhile},
-    {"if", TokenType::KeyIf},
-    {"else", TokenType::KeyElse},
-    {"void", TokenType::KeyVoid},
-    {"int", TokenType::KeyInt},
-    {"char", TokenType::KeyChar},
-    {"double", TokenType::KeyDouble},
-    {"void", TokenType::KeyVoid},
-    {"return", TokenType::KeyReturn}}
+Scanner::Scanner(const char * src, Engine engine) noexcept
+: mSource {src}
+, mEngine {engine}
+, mDecoded {}
+, mDecodedAt {}
+, mNumbers {}
+, mNumbersAt {}
+, mTokens {}
+, mStore {this}
+, mWindow(Window, {TokenType::EndOfFile, "", 0})
+, mLines {}
+, mStreaming {false}
+, mFirst {0}
+, mBuffered {0}
+, mRead {0}
+, mReadNumber {0}
+, mEnd {SIZE_MAX}
 , mStart {0}
 , mCurrent {0}
-, mLine {1} 
-, mCol {1} {
-    std::ifstream in(src); // open src file
-
-    std::stringstream strStream;
-    strStream << in.rdbuf(); // read the file into buffer
-
-    mSource = std::move(strStream.str()); // member source holds the content of the file now
-
-    in.close(); // close src file   
-}
+, mLimit {mSource.length()} { }
+
+Scanner::Scanner(const Scanner& parent, std::size_t begin, std::size_t end) noexcept
+: mSource {parent.mSource.data(), parent.mSource.length()}
+, mEngine {parent.mEngine}
+, mDecoded {}
+, mDecodedAt {}
+, mNumbers {}
+, mNumbersAt {}
+, mTokens {}
+, mStore {this}
+, mWindow(Window, {TokenType::EndOfFile, "", 0})
+, mLines {}
+, mStreaming {false}
+, mFirst {0}
+, mBuffered {0}
+, mRead {0}
+, mReadNumber {0}
+, mEnd {SIZE_MAX}
+, mStart {begin}
+, mCurrent {begin}
+, mLimit {end} { }
 
 bool Scanner::isAtEnd() const noexcept { 
-    return mCurrent >= static_cast<int>(mSource.length());
+    return mCurrent >= mSource.length();
 }
 
 char Scanner::advance() noexcept { 
-    ++mCol;
-
     return mSource[mCurrent++];
 }
 
@@ -46,7 +61,6 @@ bool Scanner::match(char expected) noexcept {
     if (isAtEnd()) return false;
     if (mSource[mCurrent] != expected) return false;
     
-    ++mCol;
     ++mCurrent;
 
     return true;
@@ -58,111 +72,126 @@ char Scanner::peek() const noexcept {
 } 
 
 char Scanner::peekNext() const noexcept {
-    if (mCurrent + 1 >= static_cast<int>(mSource.length())) return '\0';
+    if (mCurrent + 1 >= mSource.length()) return '\0';
     return mSource[mCurrent + 1];
 } 
 
 void Scanner::identifier() noexcept {
-    while (isalnum(peek()) || peek() == '_') {
-        advance();
-    }
+    std::size_t end = SimdScan::skipIdent(mSource.data(), mCurrent, mSource.length());
 
-    auto find = mKeywords.find(mSource.substr(mStart, mCurrent - mStart));
+    mCurrent = end;
 
-    if (find != mKeywords.end()) addToken(find->second);
-    else addToken(TokenType::Identifier);
+    // Identifier unless its a keyword
+    addToken(Keyword::lookup(mSource.substr(mStart, mCurrent - mStart)));
 }
 
-void Scanner::character() noexcept {
-    std::string s {""};
+bool Scanner::literal(char quote) noexcept {
+    bool plain = true;
 
-    while (peek() != '\'' && !isAtEnd()) {   
+    while (peek() != quote && !isAtEnd()) {
         if (peek() == '\\') {
+            plain = false;
+
+            // these escapes consume the next char too
             switch (peekNext()) {
                 case 'n':
-                    s += '\n';
-                    advance();
-
-                    break;
                 case 't':
-                    s += '\t';
-                    advance();
-
-                    break;
                 case '0':
-                    s += '\0';
                     advance();
-
-                    break;
-                case '\'':
-                    s += '\'';
-                    advance();
-
                     break;
                 default:
-                    s += '\\';
-                    break;  
+                    if (peekNext() == quote) advance();
+                    break;
             }
-        } else {
-            if (peek() != '\n') {
-                s += peek();
-            } 
+        } else if (peek() == '\n') {
+            // newlines are dropped from the literal
+            plain = false;
         }
 
         advance();
     }
 
-    if (isAtEnd()) {
-        addToken(TokenType::Unknown);
-        return;
-    }
-
-    // the closing '
-    advance();
+    return plain;
+}
 
-    addToken(std::move(s), TokenType::CharLit);
+void Scanner::addLines(std::size_t begin, std::size_t end) noexcept {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (mSource[i] == '\n') mLines.add(i + 1);
+    }
 }
 
-void Scanner::string() noexcept { // no support for multi-line strings
+std::string_view Scanner::decode(std::size_t begin, std::size_t end, char quote) noexcept {
     std::string s {""};
 
-    while (peek() != '\"' && !isAtEnd()) {   
-        if (peek() == '\\') {
-            switch (peekNext()) {
+    addLines(begin, end);
+
+    for (std::size_t i = begin; i < end; ++i) {
+        if (mSource[i] == '\\') {
+            char next = i + 1 < mSource.length() ? mSource[i + 1] : '\0';
+
+            switch (next) {
                 case 'n':
                     s += '\n';
-                    advance();
+                    ++i;
 
                     break;
                 case 't':
                     s += '\t';
-                    advance();
+                    ++i;
 
                     break;
                 case '0':
                     s += '\0';
-                    advance();
-
-                    break;
-                case '\"':
-                    s += '\"';
-                    advance();
+                    ++i;
 
                     break;
                 default:
-                    s += '\\';
+                    if (next == quote) {
+                        s += quote;
+                        ++i;
+                    } else {
+                        s += '\\';
+                    }
+
                     break;  
             }
-        } else {
-            if (peek() != '\n') {
-                s += peek();
-            } 
+        } else if (mSource[i] != '\n') {
+            s += mSource[i];
         }
+    }
 
-        advance();
+    mDecoded.push_back(std::move(s));
+
+    // so the batch store can find the decoded text from the token offset
+    if (!mStreaming) mDecodedAt.push_back(mStart);
+
+    return mDecoded.back();
+}
+
+void Scanner::character() noexcept {
+    bool plain = literal('\'');
+
+    // unterminated, runs to the EOF
+    if (isAtEnd()) {
+        addLines(mStart, mCurrent);
+        addToken(TokenType::Unknown);
+        return;
     }
 
+    // the closing '
+    advance();
+
+    // most literals have no escapes so the token can point straight into the source
+    if (plain) addToken(mSource.substr(mStart + 1, mCurrent - mStart - 2), TokenType::CharLit);
+    else addToken(decode(mStart + 1, mCurrent - 1, '\''), TokenType::CharLit);
+}
+
+void Scanner::string() noexcept { // no support for multi-line strings
+    bool plain = literal('\"');
+
+    // unterminated, runs to the EOF
     if (isAtEnd()) {
+        addLines(mStart, mCurrent);
         addToken(TokenType::Unknown);
         return;
     }
@@ -170,59 +199,248 @@ void Scanner::string() noexcept { // no support for multi-line strings
     // the closing "
     advance();
 
-    addToken(std::move(s), TokenType::StringLit);
+    if (plain) addToken(mSource.substr(mStart + 1, mCurrent - mStart - 2), TokenType::StringLit);
+    else addToken(decode(mStart + 1, mCurrent - 1, '\"'), TokenType::StringLit);
 }
 
 void Scanner::number() noexcept { // dont allow a leading or trailing decimal point
-    while (isdigit(peek())) advance();
+    while (CharClass::isDigit(peek())) advance();
 
     // look for a fractional part
-    if (peek() == '.' && isdigit(peekNext())) {
+    if (peek() == '.' && CharClass::isDigit(peekNext())) {
         // consume the .
         advance();
 
-        while (isdigit(peek())) advance();
+        while (CharClass::isDigit(peek())) advance();
 
-        addToken(TokenType::DoubleLit);
+        addNumber(TokenType::DoubleLit);
     } else {
-        addToken(TokenType::IntLit);
+        addNumber(TokenType::IntLit);
     }
 }
 
 void Scanner::addToken(TokenType type) noexcept {
-    // want column of start of token so need to subtract length of token str
-    mTokens.emplace_back(type, std::move(mSource.substr(mStart, mCurrent - mStart)), mLine, mCol - (mCurrent - mStart));
+    addToken(mSource.substr(mStart, mCurrent - mStart), type);
 }
 
 // for strings bc we have to account for escape characters  
-void Scanner::addToken(std::string&& s, TokenType type) noexcept {
-    mTokens.emplace_back(type, std::move(s), mLine, mCol - (mCurrent - mStart));
+void Scanner::addToken(std::string_view s, TokenType type) noexcept {
+    pushToken(type, s, mStart);
+}
+
+void Scanner::pushToken(TokenType type, std::string_view s, std::size_t offset, NumberValue number) noexcept {
+    if (mStreaming) {
+        // fill never asks for more than Window tokens so this slot is free
+        mWindow[(mFirst + mBuffered++) & (Window - 1)] = {type, s, offset, number};
+    } else {
+        // the lexeme is recovered from the offset when the token is read back
+        mTokens.push(type, offset);
+    }
+}
+
+void Scanner::addNumber(TokenType type) noexcept {
+    const char * first = mSource.data() + mStart;
+    const char * last = mSource.data() + mCurrent;
+    NumberValue number {};
+
+    // from_chars doesnt depend on the locale or throw, out of range values are left as 0
+    if (type == TokenType::IntLit) number.mInRange = std::from_chars(first, last, number.mInt).ec == std::errc();
+    else number.mInRange = std::from_chars(first, last, number.mDouble).ec == std::errc();
+
+    // the token store only keeps type/offset so the value goes in a side table
+    if (!mStreaming) {
+        mNumbers.push_back(number);
+        mNumbersAt.push_back(mStart);
+    }
+
+    pushToken(type, mSource.substr(mStart, mCurrent - mStart), mStart, number);
+}
+
+void Scanner::addEOF() noexcept {
+    pushToken(TokenType::EndOfFile, "", mSource.length());
+}
+
+std::string_view Scanner::lexeme(TokenType type, std::size_t offset) const noexcept {
+    const char * src = mSource.data();
+    std::size_t length = mSource.length();
+    std::size_t end = offset;
+
+    switch (type) {
+        case TokenType::EndOfFile:
+            return "";
+        case TokenType::StringLit:
+        case TokenType::CharLit: {
+            // literals w escapes were decoded while scanning
+            auto decoded = std::lower_bound(mDecodedAt.begin(), mDecodedAt.end(), offset);
+
+            if (decoded != mDecodedAt.end() && *decoded == offset) return mDecoded[decoded - mDecodedAt.begin()];
+
+            // plain literals have no escapes so the body runs up to the next quote
+            const char * close = static_cast<const char *>(std::memchr(src + offset + 1, src[offset], length - offset - 1));
+
+            return mSource.substr(offset + 1, close - src - offset - 1);
+        }
+        case TokenType::IntLit:
+        case TokenType::DoubleLit:
+            if (src[end] == '-') ++end;
+
+            while (end < length && CharClass::isDigit(src[end])) ++end;
+
+            if (type == TokenType::DoubleLit) {
+                // the . and the fraction
+                ++end;
+
+                while (end < length && CharClass::isDigit(src[end])) ++end;
+            }
+
+            break;
+        case TokenType::Identifier:
+        case TokenType::KeyFor:
+        case TokenType::KeyWhile:
+        case TokenType::KeyIf:
+        case TokenType::KeyElse:
+        case TokenType::KeyVoid:
+        case TokenType::KeyInt:
+        case TokenType::KeyChar:
+        case TokenType::KeyDouble:
+        case TokenType::KeyReturn:
+            end = SimdScan::skipIdent(src, offset, length);
+
+            break;
+        case TokenType::Unknown:
+            // an unterminated literal runs to EOF, anything else is a single char
+            end = (src[offset] == '\"' || src[offset] == '\'') ? length : offset + 1;
+
+            break;
+        default:
+            end = offset + Punctuator::length(type);
+
+            break;
+    }
+
+    return mSource.substr(offset, end - offset);
+}
+
+void Scanner::scanLexeme() noexcept {
+    mStart = mCurrent;
+
+    if (mEngine == Engine::Table) scanTableToken();
+    else scanToken();
 }
 
 void Scanner::scanTokens() noexcept {
-    while (!isAtEnd()) { 
-        mStart = mCurrent;
-        scanToken();
+    // a token per ~5 bytes of source is typical so this avoids most regrowth
+    mTokens.reserve(mSource.length() / 5 + 1);
+
+    while (!isAtEnd()) scanLexeme();
+
+    addEOF();
+}
+
+void Scanner::streamTokens() noexcept {
+    mStreaming = true;
+    mFirst = 0;
+    mBuffered = 0;
+
+    // ring slots are overwritten as tokens are scanned
+    mWindow.assign(Window, {TokenType::EndOfFile, "", 0});
+}
+
+void Scanner::fill(std::size_t count) noexcept {
+    while (mBuffered < count) {
+        if (!mStreaming) {
+            std::size_t end = std::min(mEnd, mStore->mTokens.size());
+
+            if (mRead < end) {
+                readToken(mRead++);
+                continue;
+            }
+
+            // the stored tokens end in EOF so it stays the last token in the ring, a range gets its own
+            if (end < mStore->mTokens.size() && (mBuffered == 0 || mWindow[(mFirst + mBuffered - 1) & (Window - 1)].mType != TokenType::EndOfFile)) {
+                mWindow[(mFirst + mBuffered++) & (Window - 1)] = {TokenType::EndOfFile, "", mStore->mTokens.offset(end)};
+            }
+
+            return;
+        }
+
+        if (isAtEnd()) {
+            // EOF is sticky, it stays the last token in the ring
+            if (mBuffered == 0 || mWindow[(mFirst + mBuffered - 1) & (Window - 1)].mType != TokenType::EndOfFile) addEOF();
+
+            return;
+        }
+
+        // each lexeme adds at most one token
+        scanLexeme();
     }
+}
+
+void Scanner::readToken(std::size_t i) noexcept {
+    TokenType type = mStore->mTokens.type(i);
+    std::size_t offset = mStore->mTokens.offset(i);
+    NumberValue number {};
+
+    // tokens are read back in order so the number values are too
+    if (type == TokenType::IntLit || type == TokenType::DoubleLit) number = mStore->mNumbers[mReadNumber++];
+
+    mWindow[(mFirst + mBuffered++) & (Window - 1)] = {type, mStore->lexeme(type, offset), offset, number};
+}
+
+void Scanner::readRange(std::size_t first, std::size_t last) noexcept {
+    const std::vector<std::size_t>& numbersAt = mStore->mNumbersAt;
+
+    mFirst = 0;
+    mBuffered = 0;
+    mRead = first;
+    mEnd = last;
 
-    mTokens.push_back({TokenType::EndOfFile, "", mLine, mCol});
+    // the number values are read back in order from the first one in the range
+    std::size_t offset = first < mStore->mTokens.size() ? mStore->mTokens.offset(first) : mSource.length();
+    mReadNumber = std::lower_bound(numbersAt.begin(), numbersAt.end(), offset) - numbersAt.begin();
+}
+
+std::unique_ptr<Scanner> Scanner::reader() const noexcept {
+    // a chunk w nothing to scan, it only reads back
+    std::unique_ptr<Scanner> retVal {new Scanner(*this, 0, 0)};
+
+    retVal->mStore = this;
+
+    return retVal;
+}
+
+Token& Scanner::peekToken(std::size_t n) noexcept {
+    fill(n + 1);
+
+    // past EOF just keep returning it
+    return mWindow[(mFirst + std::min(n, mBuffered - 1)) & (Window - 1)];
+}
+
+void Scanner::nextToken() noexcept {
+    fill(1);
+
+    if (mWindow[mFirst].mType == TokenType::EndOfFile) return;
+
+    mFirst = (mFirst + 1) & (Window - 1);
+    --mBuffered;
 }
 
 void Scanner::scanToken() noexcept {      
     // handle newlines, spaces, and tabs as we dont care about them and check them first as they are common
-    while (!isAtEnd() && (mSource[mCurrent] == ' ' || mSource[mCurrent] == '\n' || mSource[mCurrent] == '\t')) {
-        ++mCol;
-        
-        if (mSource[mCurrent] == '\n') {
-            ++mLine;
-            mCol = 1;
-        }
-
-        ++mCurrent;
+    // whole runs are skipped w the vector kernel which also counts the newlines in it
+    SimdScan::SpaceRun run = SimdScan::skipSpace(mSource.data(), mCurrent, mSource.length());
+
+    // record where each line starts, a run usually has at most one newline
+    if (run.mNewlines == 1) {
+        mLines.add(run.mLastNewline + 1);
+    } else if (run.mNewlines) {
+        addLines(mCurrent, run.mEnd);
     }
 
-    // EOF?
-    if (isAtEnd()) {
+    mCurrent = run.mEnd;
+
+    // EOF? (or the end of this chunk)
+    if (mCurrent >= mLimit) {
         return;
     }
 
@@ -232,9 +450,9 @@ void Scanner::scanToken() noexcept {
     switch (c) {
         case '/': // handle comments, only support // at the moment
             if (match('/')) {
-                while (peek() != '\n' && !isAtEnd()) {
-                    advance();
-                }
+                std::size_t end = SimdScan::findNewline(mSource.data(), mCurrent, mSource.length());
+
+                mCurrent = end;
             } else {
                 addToken(TokenType::Div);
             }
@@ -257,7 +475,7 @@ void Scanner::scanToken() noexcept {
         case '-':
             if (match('-')) addToken(TokenType::Dec);
             else if (match('=')) addToken(TokenType::MinusAssign);
-            else if (isdigit(peek())) number();
+            else if (CharClass::isDigit(peek())) number();
             else addToken(TokenType::Minus);
 
             break;
@@ -332,8 +550,8 @@ void Scanner::scanToken() noexcept {
 
             break;
         default:
-            if (isdigit(c)) number();
-            else if (isalpha(c) || c == '_') identifier();
+            if (CharClass::isDigit(c)) number();
+            else if (CharClass::isIdentStart(c)) identifier();
             else addToken(TokenType::Unknown);
 
             break;
@@ -1,49 +1,153 @@
 /*
 defines the scanner i.e. class Scanner for scanning the input file and generating a vector of tokens for the parser to use 
+
+tokens can either be scanned all at once (scanTokens) or streamed (streamTokens) in which case the parser pulls them on
+demand and only a small window of them is ever held in memory
 */
 
 #ifndef SCANNER_H
 #define SCANNER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map> 
+#include "lineTable.h"
+#include "source.h"
 #include "token.h"
+#include "tokenStore.h"
 
 class Scanner {
 public:
     // allow Parser to access all of private methods/members to implement recursive descent functions 
     friend class Parser;
     
-    // input file to be compiled
-    Scanner(const char *) noexcept;
+    // how tokens are recognized, both produce the same tokens so they can be A/B benchmarked
+    // Switch -> hand written switch over the first char, Table -> DFA generated from the token spec (see scanTable.h)
+    enum class Engine { Switch, Table };
+
+    // input file to be compiled ("-" for stdin)
+    Scanner(const char *, Engine engine = Engine::Switch) noexcept;
 
     // only use STL stuff which has mem management for me
     ~Scanner() noexcept = default;
 
+    // number of tokens buffered in streaming mode, enough lookahead for the parser (power of 2)
+    static constexpr std::size_t Window = 4;
+
     // scan all tokens by invoking scanToken iteratively which calls addToken 
     void scanTokens() noexcept;
+
+    // same tokens as scanTokens but the source is split at newlines into chunks that are scanned on threads
+    // threads = 0 uses one per core, small sources are scanned serially (see scanParallel.cpp)
+    void scanTokensParallel(unsigned threads = 0) noexcept;
+
+    // switch to streaming mode, tokens are scanned as they are pulled w peekToken()/nextToken()
+    void streamTokens() noexcept;
+
+    // token n ahead of the current one (n < Window), EOF once past the end
+    // the reference points into the ring and stays valid until the token is moved past w nextToken
+    Token& peekToken(std::size_t n = 0) noexcept;
+
+    // same but a copy
+    Token token(std::size_t n = 0) noexcept {
+        return peekToken(n);
+    }
+
+    // move past the current token (stays on EOF)
+    void nextToken() noexcept;
+
+    // number of tokens scanned including EOF (batch mode only)
+    std::size_t tokenCount() const noexcept {
+        return mTokens.size();
+    }
+
+    // index of the current token in the stored tokens (batch mode only)
+    std::size_t tokenIndex() const noexcept {
+        return mRead - mBuffered;
+    }
+
+    // batch mode: read back stored tokens [first, last) from here on, a range that stops short of the stored EOF
+    // is followed by an EOF of its own at the offset of token last (references from peekToken are invalidated)
+    void readRange(std::size_t first, std::size_t last) noexcept;
+
+    // a scanner that reads back the batch scanned tokens of this one (see readRange) w/o copying them
+    // so they can be parsed on another thread, this one must outlive it and stop scanning
+    std::unique_ptr<Scanner> reader() const noexcept;
+
+    // line starts seen so far, used to find the line/col of a token offset for error messages
+    const LineTable& lines() const noexcept {
+        return mStore->mLines;
+    }
+
+    // bytes of the input file, a compile can be keyed on them before anything is scanned (see ../parse/astCache.h)
+    const SourceBuffer& source() const noexcept {
+        return mSource;
+    }
 private:
-    // source file read into this string
-    std::string mSource; 
+    // smallest chunk worth giving its own thread in scanTokensParallel
+    static constexpr std::size_t MinChunk = 1 << 16;
+
+    // worker for one chunk [begin, end) of parents source
+    Scanner(const Scanner& parent, std::size_t begin, std::size_t end) noexcept;
+
+    // source file mapped into memory (or read in if it cant be mapped)
+    SourceBuffer mSource; 
+
+    // engine used by scanTokens
+    Engine mEngine;
+
+    // decoded text of string/char literals that contain escapes or newlines
+    // deque so the token views into it stay valid as it grows
+    std::deque<std::string> mDecoded;
+
+    // source offset of the token each mDecoded entry belongs to (ascending, batch mode only)
+    std::vector<std::size_t> mDecodedAt;
+
+    // values of the number literals and the offsets of their tokens (ascending, batch mode only)
+    std::vector<NumberValue> mNumbers;
+    std::vector<std::size_t> mNumbersAt;
+
+    // tokens in order of being read in from input file (batch mode)
+    TokenStore mTokens; 
 
-    // store keywords 
-    std::unordered_map<std::string, TokenType> mKeywords; 
+    // scanner whose mTokens/mNumbers/decoded literals/lines are read back in batch mode (this one unless a reader)
+    const Scanner * mStore;
 
-    // tokens in order of being read in from input file
-    std::vector<Token> mTokens; 
+    // ring buffer of the Window tokens handed out by peekToken, scanned into it in streaming mode and read back
+    // from mTokens in batch mode
+    std::vector<Token> mWindow;
+
+    // offset each line starts at
+    LineTable mLines;
+
+    // true if tokens are scanned on demand
+    bool mStreaming;
+
+    // ring slot of the current token
+    std::size_t mFirst;
+
+    // number of tokens buffered in the ring
+    std::size_t mBuffered;
+
+    // batch: next token in mTokens to read into the ring and the mNumbers entry of the next number literal
+    std::size_t mRead;
+    std::size_t mReadNumber;
+
+    // batch: token the range being read back stops at (SIZE_MAX -> all of them)
+    std::size_t mEnd;
 
     // index to first character of token being scanned
-    int mStart; 
+    std::size_t mStart; 
 
     // index to current character of token being scanned
-    int mCurrent; 
-
-    // current line number 
-    int mLine;
+    std::size_t mCurrent; 
 
-    // current col number
-    int mCol;
+    // no token is started at or past this index (the end of the source unless this is a chunk worker)
+    std::size_t mLimit;
     
     // consume current char and advance
     char advance() noexcept; 
@@ -54,12 +158,53 @@ private:
     // insert token into member vector tokens
     void addToken(TokenType) noexcept;
 
+    // append to mTokens or the ring buffer depending on the mode
+    void pushToken(TokenType type, std::string_view s, std::size_t offset, NumberValue number = {}) noexcept;
+
+    // parse the value of the number literal [mStart, mCurrent) and add its token
+    void addNumber(TokenType type) noexcept;
+
+    // recover the lexeme of a stored token from the source (or mDecoded)
+    std::string_view lexeme(TokenType type, std::size_t offset) const noexcept;
+
+    // add the EOF token
+    void addEOF() noexcept;
+
+    // scan (streaming) or read back (batch) until count tokens are buffered or EOF is reached
+    void fill(std::size_t count) noexcept;
+
+    // batch: copy stored token i into the ring w its lexeme/value recovered
+    void readToken(std::size_t i) noexcept;
+
     // for strings and chars bc we have to account for escape characters 
-    void addToken(std::string&& s, TokenType type) noexcept;
+    void addToken(std::string_view s, TokenType type) noexcept;
+
+    // scan the body of a string/char literal up to the closing quote
+    // returns false if any escapes/newlines were seen so the text must be decoded
+    bool literal(char quote) noexcept;
+
+    // record the start of each line after a newline in [begin, end)
+    void addLines(std::size_t begin, std::size_t end) noexcept;
+
+    // decode the literal text [begin, end) into mDecoded and return a view to it
+    // a literal w a newline in it is always decoded so its lines are recorded here
+    std::string_view decode(std::size_t begin, std::size_t end, char quote) noexcept;
+
+    // scan the next lexeme w the selected engine, adds at most one token
+    void scanLexeme() noexcept;
+
+    // scan lexemes until mLimit (the last one may run past it)
+    void scanChunk() noexcept;
+
+    // append the tokens of the next chunk, rescanning its start if the tokens so far ran into it
+    void merge(Scanner& chunk, std::size_t begin) noexcept;
 
     // scan next token by eventually calling addToken
     void scanToken() noexcept; 
 
+    // scan the next lexeme w the table driven DFA (defined in scanTable.cpp)
+    void scanTableToken() noexcept;
+
     // for chars: 'a', '1'
     void character() noexcept;
 
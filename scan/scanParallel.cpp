@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <utility>
+#include "scan.h"
+
+/*
+the source is cut right after newlines so a chunk never starts inside a // comment, but it can start inside a
+string/char literal (they may span lines) or in the middle of a whitespace run the previous chunk already skipped
+
+each chunk is scanned speculatively as if it started a lexeme, then the chunks are merged in order: if the tokens
+so far ended exactly at the chunk start its tokens are taken as is, otherwise the start of the chunk is rescanned
+serially until a token lands on the same offset as one of the chunks (from there on both scans are identical
+since scanning only depends on the position) and the rest is taken from the chunk
+*/
+
+void Scanner::scanChunk() noexcept {
+    while (mCurrent < mLimit) scanLexeme();
+}
+
+void Scanner::scanTokensParallel(unsigned threads) noexcept {
+    const char * src = mSource.data();
+    std::size_t length = mSource.length();
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // not worth the threads for small sources
+    if (length / MinChunk < threads) threads = length / MinChunk;
+
+    if (threads <= 1 || mStreaming) {
+        scanTokens();
+        return;
+    }
+
+    // chunk i is [bounds[i], bounds[i + 1]), each boundary is just past a newline
+    std::vector<std::size_t> bounds {0};
+
+    for (unsigned i = 1; i < threads; ++i) {
+        std::size_t guess = std::max(length / threads * i, bounds.back());
+        const void * newline = std::memchr(src + guess, '\n', length - guess);
+
+        if (!newline) break;
+
+        std::size_t bound = static_cast<const char *>(newline) - src + 1;
+
+        if (bound > bounds.back() && bound < length) bounds.push_back(bound);
+    }
+
+    bounds.push_back(length);
+
+    // one worker per chunk after the first (Scanner cant be moved so they live on the heap)
+    std::vector<std::unique_ptr<Scanner>> chunks;
+    std::vector<std::thread> pool;
+
+    for (std::size_t i = 1; i + 1 < bounds.size(); ++i) chunks.emplace_back(new Scanner(*this, bounds[i], bounds[i + 1]));
+
+    for (auto& chunk : chunks) pool.emplace_back([&chunk] { chunk->scanChunk(); });
+
+    mTokens.reserve(length / 5 + 1);
+
+    // the first chunk is scanned on this thread straight into the final token store
+    mLimit = bounds[1];
+    scanChunk();
+    mLimit = length;
+
+    for (std::thread& t : pool) t.join();
+
+    for (std::size_t i = 0; i < chunks.size(); ++i) merge(*chunks[i], bounds[i + 1]);
+
+    addEOF();
+}
+
+void Scanner::merge(Scanner& chunk, std::size_t begin) noexcept {
+    // first chunk token to keep and the offset its line starts/decoded literals are kept from
+    std::size_t keep = 0;
+    std::size_t from = begin;
+
+    if (mCurrent != begin) {
+        bool synced = false;
+
+        // the last token (or whitespace) ran past the chunk start so rescan until a token lines up w the chunks
+        while (!synced && mCurrent < chunk.mCurrent) {
+            std::size_t before = mTokens.size();
+
+            scanLexeme();
+
+            if (mTokens.size() == before) continue;
+
+            std::size_t offset = mTokens.offset(before);
+
+            while (keep < chunk.mTokens.size() && chunk.mTokens.offset(keep) < offset) ++keep;
+
+            if (keep < chunk.mTokens.size() && chunk.mTokens.offset(keep) == offset) {
+                synced = true;
+
+                // this token was already added by the rescan
+                ++keep;
+                from = offset + 1;
+            }
+        }
+
+        // the whole chunk was rescanned
+        if (!synced) return;
+    }
+
+    for (std::size_t i = keep; i < chunk.mTokens.size(); ++i) mTokens.push(chunk.mTokens.type(i), chunk.mTokens.offset(i));
+
+    // line 1 of the chunk is its placeholder for offset 0, a rescan has the lines up to where it stopped (the
+    // literal it synced on can span lines) so the chunk only adds the ones after them
+    for (std::size_t line = 2; line <= chunk.mLines.size(); ++line) {
+        if (chunk.mLines.start(line) > mLines.start(mLines.size())) mLines.add(chunk.mLines.start(line));
+    }
+
+    for (std::size_t i = 0; i < chunk.mNumbersAt.size(); ++i) {
+        if (chunk.mNumbersAt[i] >= from) {
+            mNumbers.push_back(chunk.mNumbers[i]);
+            mNumbersAt.push_back(chunk.mNumbersAt[i]);
+        }
+    }
+
+    for (std::size_t i = 0; i < chunk.mDecodedAt.size(); ++i) {
+        if (chunk.mDecodedAt[i] >= from) {
+            mDecoded.push_back(std::move(chunk.mDecoded[i]));
+            mDecodedAt.push_back(chunk.mDecodedAt[i]);
+        }
+    }
+
+    mCurrent = chunk.mCurrent;
+}
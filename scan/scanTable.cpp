@@ -0,0 +1,71 @@
+#include "scanTable.h"
+#include "scan.h"
+
+// generated once at compile time from Punctuator::sList
+static constexpr ScanTable sTable = ScanTable::build(Punctuator::sList);
+
+void Scanner::scanTableToken() noexcept {
+    const char * src = mSource.data();
+    std::size_t length = mSource.length();
+
+    // run the DFA until it dies, remembering the last accepting state
+    // every transition out of Start accepts so this always makes progress
+    std::uint8_t state = ScanTable::Start;
+    std::uint8_t accepted = ScanTable::Dead;
+    std::size_t end = mCurrent;
+
+    for (std::size_t i = mCurrent; i < length; ++i) {
+        state = sTable.mNext[state][static_cast<unsigned char>(src[i])];
+
+        if (state == ScanTable::Dead) break;
+
+        if (sTable.mAccept[state].mAction != ScanTable::Action::None) {
+            accepted = state;
+            end = i + 1;
+        }
+    }
+
+    mCurrent = end;
+
+    const ScanTable::Accept& accept = sTable.mAccept[accepted];
+
+    switch (accept.mAction) {
+        case ScanTable::Action::Newline:
+            mLines.add(mCurrent);
+
+            break;
+        case ScanTable::Action::Token:
+            // an unterminated literal is an Unknown token running to the EOF
+            if (accept.mType == TokenType::Unknown) addLines(mStart, mCurrent);
+
+            addToken(accept.mType);
+
+            break;
+        case ScanTable::Action::Number:
+            addNumber(accept.mType);
+
+            break;
+        case ScanTable::Action::Ident:
+            addToken(Keyword::lookup(mSource.substr(mStart, mCurrent - mStart)));
+
+            break;
+        case ScanTable::Action::StringPlain:
+            addToken(mSource.substr(mStart + 1, mCurrent - mStart - 2), TokenType::StringLit);
+
+            break;
+        case ScanTable::Action::StringEscaped:
+            addToken(decode(mStart + 1, mCurrent - 1, '\"'), TokenType::StringLit);
+
+            break;
+        case ScanTable::Action::CharPlain:
+            addToken(mSource.substr(mStart + 1, mCurrent - mStart - 2), TokenType::CharLit);
+
+            break;
+        case ScanTable::Action::CharEscaped:
+            addToken(decode(mStart + 1, mCurrent - 1, '\''), TokenType::CharLit);
+
+            break;
+        default: // spaces, tabs, comments
+            break;
+    }
+}
@@ -0,0 +1,203 @@
+/*
+defines class ScanTable which is the DFA used by the table driven scanner engine (Scanner::Engine::Table)
+
+the transition table is generated at compile time from the token spec in token.h (Punctuator::sList) plus the fixed
+lexical rules for identifiers, numbers, whitespace, // comments and string/char literals
+
+one state per byte of input: next = mNext[state][byte], a token ends when the next state is Dead
+and the longest accepting prefix wins (maximal munch) e.g. "1." backs off to the int 1
+*/
+
+#ifndef SCANTABLE_H
+#define SCANTABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "token.h"
+
+// DFA states and the spec dependent state count, split out so NumStates can size the tables below
+class ScanState {
+public:
+    // states that exist regardless of the spec
+    enum : std::uint8_t {
+        Dead, Start,
+        Ident, Int, IntDot, Double, Space, Newline, Comment,
+        StrPlain, StrDirty, StrEsc, StrDonePlain, StrDoneEscaped,
+        CharPlain, CharDirty, CharEsc, CharDonePlain, CharDoneEscaped,
+        Unknown,
+        FirstTrie // first state used by the Punctuator trie
+    };
+
+    // number of trie states needed for the spec (one per distinct proper prefix)
+    template <std::size_t N>
+    static constexpr std::size_t countTrie(const Punctuator::Entry (&spec)[N]) noexcept {
+        std::size_t count = 0;
+
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t len = 1; len <= spec[i].mText.size(); ++len) {
+                std::string_view prefix = spec[i].mText.substr(0, len);
+                bool seen = false;
+
+                // only count the prefix the first time it shows up
+                for (std::size_t j = 0; j < i && !seen; ++j) {
+                    seen = spec[j].mText.substr(0, len) == prefix && spec[j].mText.size() >= len;
+                }
+
+                if (!seen) ++count;
+            }
+        }
+
+        return count;
+    }
+};
+
+class ScanTable : public ScanState {
+public:
+    // what the scanner does w the lexeme once the DFA stops
+    enum class Action : std::uint8_t {
+        None,           // not an accepting state
+        Token,          // emit mType
+        Skip,           // spaces/tabs/comments
+        Newline,        // a single '\n'
+        Number,         // int/double literal, emit mType w its value
+        Ident,          // identifier or keyword
+        StringPlain,    // string literal w no escapes, view the source
+        StringEscaped,  // string literal that must be decoded
+        CharPlain,      // char literal w no escapes, view the source
+        CharEscaped     // char literal that must be decoded
+    };
+
+    struct Accept {
+        Action mAction;
+        TokenType mType;
+    };
+
+    static constexpr std::size_t NumStates = FirstTrie + countTrie(Punctuator::sList);
+
+    static_assert(NumStates <= 256, "scan table states must fit in a byte");
+
+    // mNext[state][byte] -> next state
+    std::array<std::array<std::uint8_t, 256>, NumStates> mNext;
+
+    // accept info for each state
+    std::array<Accept, NumStates> mAccept;
+
+    // build the table for the spec
+    template <std::size_t N>
+    static constexpr ScanTable build(const Punctuator::Entry (&spec)[N]) noexcept {
+        ScanTable t {};
+
+        for (std::size_t s = 0; s < NumStates; ++s) {
+            for (std::size_t c = 0; c < 256; ++c) t.mNext[s][c] = Dead;
+
+            t.mAccept[s] = {Action::None, TokenType::Unknown};
+        }
+
+        // any byte not covered below is a single char Unknown token
+        for (std::size_t c = 0; c < 256; ++c) t.mNext[Start][c] = Unknown;
+
+        t.mAccept[Unknown] = {Action::Token, TokenType::Unknown};
+
+        // identifiers [a-zA-Z_][a-zA-Z0-9_]*
+        for (int c = 'a'; c <= 'z'; ++c) t.mNext[Start][c] = t.mNext[Ident][c] = Ident;
+        for (int c = 'A'; c <= 'Z'; ++c) t.mNext[Start][c] = t.mNext[Ident][c] = Ident;
+        for (int c = '0'; c <= '9'; ++c) t.mNext[Ident][c] = Ident;
+
+        t.mNext[Start]['_'] = t.mNext[Ident]['_'] = Ident;
+        t.mAccept[Ident] = {Action::Ident, TokenType::Identifier};
+
+        // numbers [0-9]+ and [0-9]+.[0-9]+ (a '-' in front is handled by the trie below)
+        for (int c = '0'; c <= '9'; ++c) {
+            t.mNext[Start][c] = t.mNext[Int][c] = Int;
+            t.mNext[IntDot][c] = t.mNext[Double][c] = Double;
+        }
+
+        t.mNext[Int]['.'] = IntDot;
+        t.mAccept[Int] = {Action::Number, TokenType::IntLit};
+        t.mAccept[Double] = {Action::Number, TokenType::DoubleLit};
+
+        // runs of spaces/tabs are skipped, newlines are one char each so lines can be counted per token
+        t.mNext[Start][' '] = t.mNext[Start]['\t'] = t.mNext[Space][' '] = t.mNext[Space]['\t'] = Space;
+        t.mNext[Start]['\n'] = Newline;
+        t.mAccept[Space] = {Action::Skip, TokenType::Unknown};
+        t.mAccept[Newline] = {Action::Newline, TokenType::Unknown};
+
+        // literals, an unterminated literal is an Unknown token running to EOF
+        addLiteral(t, '"', StrPlain, StrDirty, StrEsc, StrDonePlain, StrDoneEscaped);
+        addLiteral(t, '\'', CharPlain, CharDirty, CharEsc, CharDonePlain, CharDoneEscaped);
+
+        t.mAccept[StrDonePlain] = {Action::StringPlain, TokenType::StringLit};
+        t.mAccept[StrDoneEscaped] = {Action::StringEscaped, TokenType::StringLit};
+        t.mAccept[CharDonePlain] = {Action::CharPlain, TokenType::CharLit};
+        t.mAccept[CharDoneEscaped] = {Action::CharEscaped, TokenType::CharLit};
+
+        // operators and punctuation as a trie
+        std::size_t nextFree = FirstTrie;
+
+        for (std::size_t i = 0; i < N; ++i) {
+            std::size_t state = Start;
+
+            for (char ch : spec[i].mText) {
+                unsigned char c = static_cast<unsigned char>(ch);
+
+                if (t.mNext[state][c] == Dead || t.mNext[state][c] == Unknown) {
+                    t.mNext[state][c] = static_cast<std::uint8_t>(nextFree);
+
+                    // a one char prefix that is not itself a token (e.g. '|') is Unknown
+                    if (state == Start) t.mAccept[nextFree] = {Action::Token, TokenType::Unknown};
+
+                    ++nextFree;
+                }
+
+                state = t.mNext[state][c];
+            }
+
+            t.mAccept[state] = {Action::Token, spec[i].mType};
+        }
+
+        // "//" starts a comment that runs up to (not including) the newline
+        std::size_t slash = t.mNext[Start]['/'];
+
+        t.mNext[slash]['/'] = Comment;
+
+        for (std::size_t c = 0; c < 256; ++c) {
+            if (c != '\n') t.mNext[Comment][c] = Comment;
+        }
+
+        t.mAccept[Comment] = {Action::Skip, TokenType::Unknown};
+
+        // '-' directly followed by a digit is a negative number
+        std::size_t minus = t.mNext[Start]['-'];
+
+        for (int c = '0'; c <= '9'; ++c) t.mNext[minus][c] = Int;
+
+        return t;
+    }
+private:
+    // states for a literal w the given quote
+    // plain -> no escapes/newlines seen yet, dirty -> the text must be decoded, esc -> just saw a '\'
+    static constexpr void addLiteral(ScanTable& t, char quote, std::uint8_t plain, std::uint8_t dirty, std::uint8_t esc, std::uint8_t donePlain, std::uint8_t doneEscaped) noexcept {
+        unsigned char q = static_cast<unsigned char>(quote);
+
+        for (std::size_t c = 0; c < 256; ++c) {
+            t.mNext[plain][c] = plain;
+            t.mNext[dirty][c] = dirty;
+
+            // after a '\' the next char is consumed as part of the escape (or as a normal char)
+            t.mNext[esc][c] = dirty;
+        }
+
+        t.mNext[Start][q] = plain;
+
+        t.mNext[plain]['\n'] = dirty;
+        t.mNext[plain]['\\'] = t.mNext[dirty]['\\'] = t.mNext[esc]['\\'] = esc;
+        t.mNext[plain][q] = donePlain;
+        t.mNext[dirty][q] = doneEscaped;
+
+        t.mAccept[plain] = t.mAccept[dirty] = t.mAccept[esc] = {Action::Token, TokenType::Unknown};
+    }
+};
+
+#endif
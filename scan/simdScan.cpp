@@ -0,0 +1,257 @@
+#include "charClass.h"
+#include "simdScan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CRISP_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+------------------------------------------------------
+scalar kernels (also used for the tail of the vector kernels)
+*/
+
+static SimdScan::SpaceRun skipSpaceScalar(const char * src, std::size_t pos, std::size_t len) noexcept {
+    SimdScan::SpaceRun run {pos, 0, 0};
+
+    while (pos < len && CharClass::isSpace(src[pos])) {
+        if (src[pos] == '\n') {
+            ++run.mNewlines;
+            run.mLastNewline = pos;
+        }
+
+        ++pos;
+    }
+
+    run.mEnd = pos;
+
+    return run;
+}
+
+static std::size_t skipIdentScalar(const char * src, std::size_t pos, std::size_t len) noexcept {
+    while (pos < len && CharClass::isIdentChar(src[pos])) ++pos;
+
+    return pos;
+}
+
+static std::size_t findNewlineScalar(const char * src, std::size_t pos, std::size_t len) noexcept {
+    while (pos < len && src[pos] != '\n') ++pos;
+
+    return pos;
+}
+
+// add the newlines in mask (bit i set -> src[base + i] is '\n') to the run
+static void addNewlines(SimdScan::SpaceRun& run, unsigned mask, std::size_t base) noexcept {
+    if (mask) {
+        run.mNewlines += __builtin_popcount(mask);
+        run.mLastNewline = base + 31 - __builtin_clz(mask);
+    }
+}
+
+// finish a run w the scalar kernel from pos
+static SimdScan::SpaceRun finishSpace(SimdScan::SpaceRun run, const char * src, std::size_t pos, std::size_t len) noexcept {
+    SimdScan::SpaceRun tail = skipSpaceScalar(src, pos, len);
+
+    if (tail.mNewlines) {
+        run.mNewlines += tail.mNewlines;
+        run.mLastNewline = tail.mLastNewline;
+    }
+
+    run.mEnd = tail.mEnd;
+
+    return run;
+}
+
+#ifdef CRISP_X86
+
+/*
+------------------------------------------------------
+SSE2 kernels (16 bytes at a time)
+*/
+
+__attribute__((target("sse2")))
+static SimdScan::SpaceRun skipSpaceSSE2(const char * src, std::size_t pos, std::size_t len) noexcept {
+    SimdScan::SpaceRun run {pos, 0, 0};
+
+    const __m128i sp = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i nl = _mm_set1_epi8('\n');
+
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + pos));
+        __m128i isNl = _mm_cmpeq_epi8(v, nl);
+        __m128i isSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)), isNl);
+
+        unsigned nls = _mm_movemask_epi8(isNl);
+        unsigned stop = ~_mm_movemask_epi8(isSpace) & 0xFFFF;
+
+        if (stop) {
+            unsigned n = __builtin_ctz(stop);
+
+            // only count newlines before the first non whitespace char
+            addNewlines(run, nls & ((1u << n) - 1), pos);
+            run.mEnd = pos + n;
+
+            return run;
+        }
+
+        addNewlines(run, nls, pos);
+    }
+
+    return finishSpace(run, src, pos, len);
+}
+
+// bit i set if byte i is [a-zA-Z0-9_]
+__attribute__((target("sse2")))
+static inline unsigned identMaskSSE2(__m128i v) noexcept {
+    // bytes >= 128 are negative in the signed compares so they never match
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    __m128i under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), under));
+}
+
+__attribute__((target("sse2")))
+static std::size_t skipIdentSSE2(const char * src, std::size_t pos, std::size_t len) noexcept {
+    for (; pos + 16 <= len; pos += 16) {
+        unsigned stop = ~identMaskSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + pos))) & 0xFFFF;
+
+        if (stop) return pos + __builtin_ctz(stop);
+    }
+
+    return skipIdentScalar(src, pos, len);
+}
+
+__attribute__((target("sse2")))
+static std::size_t findNewlineSSE2(const char * src, std::size_t pos, std::size_t len) noexcept {
+    const __m128i nl = _mm_set1_epi8('\n');
+
+    for (; pos + 16 <= len; pos += 16) {
+        unsigned hit = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + pos)), nl));
+
+        if (hit) return pos + __builtin_ctz(hit);
+    }
+
+    return findNewlineScalar(src, pos, len);
+}
+
+/*
+------------------------------------------------------
+AVX2 kernels (32 bytes at a time)
+*/
+
+__attribute__((target("avx2")))
+static SimdScan::SpaceRun skipSpaceAVX2(const char * src, std::size_t pos, std::size_t len) noexcept {
+    SimdScan::SpaceRun run {pos, 0, 0};
+
+    const __m256i sp = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i nl = _mm256_set1_epi8('\n');
+
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + pos));
+        __m256i isNl = _mm256_cmpeq_epi8(v, nl);
+        __m256i isSpace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tab)), isNl);
+
+        unsigned nls = _mm256_movemask_epi8(isNl);
+        unsigned stop = ~static_cast<unsigned>(_mm256_movemask_epi8(isSpace));
+
+        if (stop) {
+            unsigned n = __builtin_ctz(stop);
+
+            addNewlines(run, nls & ((1u << n) - 1), pos);
+            run.mEnd = pos + n;
+
+            return run;
+        }
+
+        addNewlines(run, nls, pos);
+    }
+
+    return finishSpace(run, src, pos, len);
+}
+
+__attribute__((target("avx2")))
+static inline unsigned identMaskAVX2(__m256i v) noexcept {
+    // AVX2 has no cmplt so flip the operands of cmpgt
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+    __m256i under = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+
+    return _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(alpha, digit), under));
+}
+
+__attribute__((target("avx2")))
+static std::size_t skipIdentAVX2(const char * src, std::size_t pos, std::size_t len) noexcept {
+    for (; pos + 32 <= len; pos += 32) {
+        unsigned stop = ~identMaskAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + pos)));
+
+        if (stop) return pos + __builtin_ctz(stop);
+    }
+
+    // identifiers are usually short so let SSE2 handle the rest before going scalar
+    return skipIdentSSE2(src, pos, len);
+}
+
+__attribute__((target("avx2")))
+static std::size_t findNewlineAVX2(const char * src, std::size_t pos, std::size_t len) noexcept {
+    const __m256i nl = _mm256_set1_epi8('\n');
+
+    for (; pos + 32 <= len; pos += 32) {
+        unsigned hit = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + pos)), nl));
+
+        if (hit) return pos + __builtin_ctz(hit);
+    }
+
+    return findNewlineSSE2(src, pos, len);
+}
+
+#endif
+
+/*
+------------------------------------------------------
+SimdScan methods
+*/
+
+SimdScan::Level SimdScan::best() noexcept {
+#ifdef CRISP_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Level::SSE2;
+#endif
+
+    return Level::Scalar;
+}
+
+SimdScan::Kernels SimdScan::make(Level level) noexcept {
+    switch (level) {
+#ifdef CRISP_X86
+        case Level::AVX2:
+            return {skipSpaceAVX2, skipIdentAVX2, findNewlineAVX2, Level::AVX2};
+        case Level::SSE2:
+            return {skipSpaceSSE2, skipIdentSSE2, findNewlineSSE2, Level::SSE2};
+#endif
+        default:
+            return {skipSpaceScalar, skipIdentScalar, findNewlineScalar, Level::Scalar};
+    }
+}
+
+SimdScan::Kernels& SimdScan::kernels() noexcept {
+    static Kernels kernels = make(best());
+
+    return kernels;
+}
+
+SimdScan::Level SimdScan::level() noexcept {
+    return kernels().mLevel;
+}
+
+void SimdScan::setLevel(Level level) noexcept {
+    Level max = best();
+
+    kernels() = make(static_cast<int>(level) > static_cast<int>(max) ? max : level);
+}
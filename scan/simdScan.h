@@ -0,0 +1,68 @@
+/*
+defines class SimdScan which holds the vectorized kernels the scanner uses for its hot loops
+
+each kernel classifies 16 (SSE2) or 32 (AVX2) bytes at once to find the end of a whitespace run, a // comment or an identifier
+the widest level the cpu supports is picked once at runtime, w a portable scalar fallback (non x86 targets use scalar only)
+*/
+
+#ifndef SIMDSCAN_H
+#define SIMDSCAN_H
+
+#include <cstddef>
+
+class SimdScan {
+public:
+    enum class Level { Scalar, SSE2, AVX2 };
+
+    // result of skipping a whitespace run
+    struct SpaceRun {
+        // index of first non whitespace char (or len)
+        std::size_t mEnd;
+
+        // number of '\n' in the run
+        std::size_t mNewlines;
+
+        // index of the last '\n' in the run (only valid if mNewlines > 0)
+        std::size_t mLastNewline;
+    };
+
+    // skip ' ', '\t', '\n' starting at src[pos] and count the newlines passed
+    static SpaceRun skipSpace(const char * src, std::size_t pos, std::size_t len) noexcept {
+        return kernels().mSkipSpace(src, pos, len);
+    }
+
+    // index of the first char at or after pos that is not [a-zA-Z0-9_] (or len)
+    static std::size_t skipIdent(const char * src, std::size_t pos, std::size_t len) noexcept {
+        return kernels().mSkipIdent(src, pos, len);
+    }
+
+    // index of the first '\n' at or after pos (or len) i.e. end of a // comment
+    static std::size_t findNewline(const char * src, std::size_t pos, std::size_t len) noexcept {
+        return kernels().mFindNewline(src, pos, len);
+    }
+
+    // level currently in use
+    static Level level() noexcept;
+
+    // force a level (clamped to what the cpu supports) so the kernels can be A/B benchmarked
+    static void setLevel(Level level) noexcept;
+private:
+    // one function pointer per kernel for a given level
+    struct Kernels {
+        SpaceRun (*mSkipSpace)(const char *, std::size_t, std::size_t) noexcept;
+        std::size_t (*mSkipIdent)(const char *, std::size_t, std::size_t) noexcept;
+        std::size_t (*mFindNewline)(const char *, std::size_t, std::size_t) noexcept;
+        Level mLevel;
+    };
+
+    // kernels in use, picked on first use
+    static Kernels& kernels() noexcept;
+
+    // widest level the cpu (and os) supports
+    static Level best() noexcept;
+
+    // kernel table for a level
+    static Kernels make(Level level) noexcept;
+};
+
+#endif
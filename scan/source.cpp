@@ -0,0 +1,60 @@
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source.h"
+
+SourceBuffer::SourceBuffer(const char * path) noexcept
+: mData {""}
+, mLength {0}
+, mMapping {nullptr}
+, mOwned {} {
+    if (std::strcmp(path, "-") == 0) {
+        readAll(STDIN_FILENO);
+        return;
+    }
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd == -1) return;
+
+    struct stat st;
+
+    // only regular non empty files can be mapped, mmap of length 0 fails
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void * map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED) {
+            // scanner walks the file front to back so let the kernel read ahead aggressively
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+            mMapping = map;
+            mData = static_cast<const char *>(map);
+            mLength = st.st_size;
+        } else {
+            readAll(fd);
+        }
+    } else {
+        readAll(fd);
+    }
+
+    // mapping stays valid after the fd is closed
+    close(fd);
+}
+
+SourceBuffer::~SourceBuffer() noexcept {
+    if (mMapping) munmap(mMapping, mLength);
+}
+
+void SourceBuffer::readAll(int fd) noexcept {
+    char buf[65536];
+    ssize_t n;
+
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        mOwned.append(buf, n);
+    }
+
+    mData = mOwned.data();
+    mLength = mOwned.size();
+}
@@ -0,0 +1,73 @@
+/*
+defines the source buffer i.e. class SourceBuffer which holds the bytes of the input file for the scanner
+
+regular files are mapped into memory with mmap so the scanner reads the page cache directly w/o copying
+stdin, pipes and anything else that cant be mapped falls back to being read into a std::string
+the bytes stay valid for the lifetime of the buffer so diagnostics can reuse them after scanning
+*/
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class SourceBuffer {
+public:
+    // map (or read) the file at path, "-" reads from stdin
+    SourceBuffer(const char * path) noexcept;
+
+    // view of bytes owned by another buffer (the parallel scanners chunk workers share the parents source)
+    SourceBuffer(const char * data, std::size_t length) noexcept
+    : mData {data}
+    , mLength {length}
+    , mMapping {nullptr}
+    , mOwned {} { }
+
+    // unmap the file if it was mapped
+    ~SourceBuffer() noexcept;
+
+    // owns a mapping so no copies
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    const char * data() const noexcept {
+        return mData;
+    }
+
+    std::size_t length() const noexcept {
+        return mLength;
+    }
+
+    char operator[](std::size_t i) const noexcept {
+        return mData[i];
+    }
+
+    // view of [pos, pos + len) into the buffer
+    std::string_view substr(std::size_t pos, std::size_t len) const noexcept {
+        return std::string_view(mData + pos, len);
+    }
+
+    // true if the bytes are backed by an mmap instead of mOwned
+    bool isMapped() const noexcept {
+        return mMapping != nullptr;
+    }
+private:
+    // read everything from fd into mOwned (fallback for stdin/pipes or if mmap fails)
+    void readAll(int fd) noexcept;
+
+    // first byte of the source (either into the mapping or mOwned)
+    const char * mData;
+
+    // number of bytes in the source
+    std::size_t mLength;
+
+    // start of the mapping or nullptr if not mapped
+    void * mMapping;
+
+    // used when the source could not be mapped
+    std::string mOwned;
+};
+
+#endif
@@ -56,11 +56,9 @@ std::unordered_map<TokenType, std::string> Token::mToString = {
     {TokenType::EndOfFile, "EOF"},
 };
 
-Token::Token(TokenType t, std::string&& s, int l, int c) noexcept
+Token::Token(TokenType t, std::string_view s, std::size_t o, NumberValue n) noexcept
 : mType {t}
-, mStr {std::move(s)}
-, mLine {l}
-, mCol {c} { }
-
-
-
+, mAtom {t == TokenType::Identifier ? Atoms::intern(s) : Atoms::None}
+, mStr {s}
+, mOffset {o}
+, mNumber {n} { }
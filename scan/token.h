@@ -5,10 +5,17 @@ defines the types of tokens i.e. enum class TokenType and a wrapper class i.e To
 #ifndef TOKEN_H
 #define TOKEN_H 
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include "atoms.h"
 
-enum class TokenType {
+// one byte so the packed token store (tokenStore.h) spends a single byte per token on it
+enum class TokenType : std::uint8_t {
     // literals
     Identifier, CharLit, IntLit, DoubleLit, StringLit,
     
@@ -25,32 +32,200 @@ enum class TokenType {
     SemiColon, LBrace, RBrace, Comma, Unknown, EndOfFile
 };
 
+// value of an IntLit/DoubleLit, computed once by the scanner w std::from_chars
+struct NumberValue {
+    union {
+        int mInt;
+        double mDouble;
+    };
+
+    // false if the literal does not fit in its type (the value is then 0)
+    bool mInRange;
+};
+
 class Token {
 public:
     // allow Parser to access all of private methods/members 
     friend class Parser;
 
+    // Scanner checks token types when streaming
+    friend class Scanner;
+
     // store map from TokenType to the its string name -> map[TokenType::...] = "..."
     static std::unordered_map<TokenType, std::string> mToString;
 
-    Token(TokenType type, std::string&& str, int line, int col) noexcept;
+    Token(TokenType type, std::string_view str, std::size_t offset, NumberValue number = {}) noexcept;
 
     // only using STL stuff which has mem management for me
     ~Token() noexcept = default;
+
+    TokenType type() const noexcept {
+        return mType;
+    }
+
+    std::string_view text() const noexcept {
+        return mStr;
+    }
+
+    // interned spelling of an Identifier (Atoms::None for any other token)
+    Atom atom() const noexcept {
+        return mAtom;
+    }
+
+    std::size_t offset() const noexcept {
+        return mOffset;
+    }
+
+    NumberValue number() const noexcept {
+        return mNumber;
+    }
 private:
     // token type
     TokenType mType;
 
-    // string of TokenType from source file
-    std::string mStr; 
+    // set when the token is made so the parser never hashes an identifier itself
+    Atom mAtom;
+
+    // lexeme of the token, points into the scanners source buffer
+    // (or into its decoded side buffer for string/char literals w escapes)
+    std::string_view mStr; 
+
+    // offset of the token in the source, line/col are computed from it (Scanner::line/col) only for error messages
+    std::size_t mOffset;
+
+    // value of a number literal (unused for other tokens)
+    NumberValue mNumber;
+};
+
+// fixed spelling tokens (operators and punctuation)
+// the table driven scanner builds its DFA from this list at compile time so keep it in sync w Scanner::scanToken
+class Punctuator {
+public:
+    struct Entry {
+        std::string_view mText;
+        TokenType mType;
+    };
+
+    static constexpr Entry sList[] = {
+        {"=", TokenType::Assign},
+        {"+", TokenType::Plus},
+        {"-", TokenType::Minus},
+        {"*", TokenType::Mult},
+        {"/", TokenType::Div},
+        {"%", TokenType::Mod},
+        {"++", TokenType::Inc},
+        {"--", TokenType::Dec},
+        {"[", TokenType::LBracket},
+        {"]", TokenType::RBracket},
+        {"==", TokenType::EqualTo},
+        {"!=", TokenType::NotEqual},
+        {"||", TokenType::Or},
+        {"&&", TokenType::And},
+        {"!", TokenType::Not},
+        {"<", TokenType::LessThan},
+        {">", TokenType::GreaterThan},
+        {"(", TokenType::LParen},
+        {")", TokenType::RParen},
+        {"&", TokenType::Addr},
+        {"+=", TokenType::IncAssign},
+        {"-=", TokenType::MinusAssign},
+        {"<=", TokenType::LThanOrEq},
+        {">=", TokenType::GThanOrEq},
+        {";", TokenType::SemiColon},
+        {"{", TokenType::LBrace},
+        {"}", TokenType::RBrace},
+        {",", TokenType::Comma}
+    };
+
+    // spelling length of a punctuator type (0 for any other type)
+    static std::size_t length(TokenType type) noexcept {
+        return sLengths[static_cast<std::size_t>(type)];
+    }
+private:
+    static constexpr std::size_t NumTypes = static_cast<std::size_t>(TokenType::EndOfFile) + 1;
+
+    static constexpr std::array<std::uint8_t, NumTypes> makeLengths() noexcept {
+        std::array<std::uint8_t, NumTypes> lengths {};
+
+        for (const Entry& entry : sList) lengths[static_cast<std::size_t>(entry.mType)] = entry.mText.size();
 
-    // line number (for error messages down the line)
-    int mLine; 
+        return lengths;
+    }
 
-    // column number (for error messages down the line)
-    int mCol;
+    // one entry per TokenType, defined below once the class is complete
+    static const std::array<std::uint8_t, NumTypes> sLengths;
 };
 
+inline constexpr std::array<std::uint8_t, Punctuator::NumTypes> Punctuator::sLengths = Punctuator::makeLengths();
+
+// keyword spellings, the scanner classifies identifiers against these w a perfect hash built at compile time
+class Keyword {
+public:
+    // TokenType of text if it is a keyword otherwise TokenType::Identifier
+    // allocation free and at most one string compare
+    static constexpr TokenType lookup(std::string_view text) noexcept {
+        if (text.size() < MinLength || text.size() > MaxLength) return TokenType::Identifier;
+
+        const Entry& entry = sTable[hash(text)];
+
+        return entry.mText == text ? entry.mType : TokenType::Identifier;
+    }
+
+    // true if no two keywords hash to the same slot (checked by static_assert below)
+    static constexpr bool isPerfect() noexcept {
+        for (std::size_t i = 0; i < std::size(sList); ++i) {
+            if (sTable[hash(sList[i].mText)].mText != sList[i].mText) return false;
+        }
+
+        return true;
+    }
+private:
+    struct Entry {
+        std::string_view mText;
+        TokenType mType;
+    };
+
+    // shortest and longest keyword
+    static constexpr std::size_t MinLength = 2;
+    static constexpr std::size_t MaxLength = 6;
+
+    // number of slots in sTable (power of 2)
+    static constexpr std::size_t Slots = 16;
+
+    static constexpr Entry sList[] = {
+        {"for", TokenType::KeyFor},
+        {"while", TokenType::KeyWhile},
+        {"if", TokenType::KeyIf},
+        {"else", TokenType::KeyElse},
+        {"void", TokenType::KeyVoid},
+        {"int", TokenType::KeyInt},
+        {"char", TokenType::KeyChar},
+        {"double", TokenType::KeyDouble},
+        {"return", TokenType::KeyReturn}
+    };
+
+    // second char + length is collision free for the keywords above (all have length >= 2)
+    static constexpr std::size_t hash(std::string_view text) noexcept {
+        return (static_cast<unsigned char>(text[1]) + text.size()) & (Slots - 1);
+    }
+
+    static constexpr std::array<Entry, Slots> makeTable() noexcept {
+        std::array<Entry, Slots> table {};
+
+        for (std::size_t i = 0; i < Slots; ++i) table[i] = {"", TokenType::Identifier};
+        for (const Entry& entry : sList) table[hash(entry.mText)] = entry;
+
+        return table;
+    }
+
+    // slot -> keyword, defined below once the class is complete
+    static const std::array<Entry, Slots> sTable;
+};
+
+inline constexpr std::array<Keyword::Entry, Keyword::Slots> Keyword::sTable = Keyword::makeTable();
+
+static_assert(Keyword::isPerfect(), "keyword hash has a collision, change Keyword::hash or Keyword::Slots");
+
 /*
 
 Lexeme: a sequence of characters in program that matches a pattern
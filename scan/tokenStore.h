@@ -0,0 +1,69 @@
+/*
+defines class TokenStore which holds the scanned tokens as parallel arrays (struct of arrays)
+
+each token is only its 1 byte TokenType and a 32 bit source offset (5 bytes instead of a full Token), the lexeme is
+recovered from the source when a Token is materialized (see Scanner::token) and line/col only when an error needs them
+
+offsets past 4 GiB are supported by recording the token index where each further 4 GiB segment of the source starts
+*/
+
+#ifndef TOKENSTORE_H
+#define TOKENSTORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "token.h"
+
+class TokenStore {
+public:
+    TokenStore() noexcept = default;
+
+    ~TokenStore() noexcept = default;
+
+    void push(TokenType type, std::size_t offset) noexcept {
+        // tokens are pushed in source order so a new segment starts when the high bits of the offset change
+        while ((offset >> 32) > mSegments.size()) mSegments.push_back(mTypes.size());
+
+        mTypes.push_back(type);
+        mOffsets.push_back(static_cast<std::uint32_t>(offset));
+    }
+
+    std::size_t size() const noexcept {
+        return mTypes.size();
+    }
+
+    TokenType type(std::size_t i) const noexcept {
+        return mTypes[i];
+    }
+
+    std::size_t offset(std::size_t i) const noexcept {
+        // almost always empty, only sources over 4 GiB have segments
+        std::size_t high = std::upper_bound(mSegments.begin(), mSegments.end(), i) - mSegments.begin();
+
+        return (high << 32) | mOffsets[i];
+    }
+
+    void reserve(std::size_t n) noexcept {
+        mTypes.reserve(n);
+        mOffsets.reserve(n);
+    }
+
+    void clear() noexcept {
+        mTypes.clear();
+        mOffsets.clear();
+        mSegments.clear();
+    }
+private:
+    // type of each token
+    std::vector<TokenType> mTypes;
+
+    // low 32 bits of the source offset of each token
+    std::vector<std::uint32_t> mOffsets;
+
+    // mSegments[k] is the index of the first token at or past offset (k + 1) * 4 GiB
+    std::vector<std::size_t> mSegments;
+};
+
+#endif
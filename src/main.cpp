@@ -1,18 +1,93 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <unistd.h>  
 #include "../scan/scan.h"
+#include "../parse/astCache.h"
+#include "../parse/astNodes.h"
 #include "../parse/parse.h"
 #include "../parse/symbols.h"
-#include "../error/parseExcept.h"
 #include "../emitIR/emitter.h"
 
+namespace {
+    // verify, optimize and print the IR of emit
+    int finish(Emitter& emit) {
+        // if llvm ir gen has error(s) print to cerr and w compilation 
+        if (!emit.verify()) {
+            return 1;
+        }
+
+        // print llvm ir to stdout 
+        // std::cout << "\nIR before LLVM passes:\n";
+        // emit.print();
+
+        // continue optimizations and mem2reg pass for SSA form 
+        emit.optimize();
+
+        // print optimized llvm ir to stdout 
+        // std::cout << "\nIR after LLVM passes:\n";
+        emit.print();
+
+        // generate bitcode from llvm ir
+        // emit.bitcode();
+
+        return 0;
+    }
+}
+
 int main(int argc, char * argv[]) {
-    if (argc != 2) {
+    const char * fileName = nullptr;
+    const char * cacheDir = nullptr;
+    bool printAST = false;
+    bool syntaxOnly = false;
+    Parser::Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-a") == 0) {
+            printAST = true;
+        } else if (std::strcmp(argv[i], "-fsyntax-only") == 0) {
+            syntaxOnly = true;
+        } else if (std::strncmp(argv[i], "-fparse-threads=", 16) == 0) {
+            options.mThreads = std::max(0, std::atoi(argv[i] + 16));
+        } else if (std::strncmp(argv[i], "-fnesting-depth=", 16) == 0) {
+            options.mMaxDepth = std::clamp(std::atoi(argv[i] + 16), 1, static_cast<int>(Parser::MaxSafeDepth));
+        } else if (std::strncmp(argv[i], "-ferror-limit=", 14) == 0) {
+            options.mErrorLimit = std::max(0, std::atoi(argv[i] + 14));
+        } else if (std::strcmp(argv[i], "-flazy-functions") == 0) {
+            if (options.mRoots.empty()) options.mRoots.emplace_back("main");
+        } else if (std::strncmp(argv[i], "-fexport=", 9) == 0) {
+            // the export list replaces main as the root
+            options.mRoots.clear();
+
+            for (const char * name = argv[i] + 9; *name; ) {
+                const char * end = std::strchr(name, ',');
+
+                if (!end) end = name + std::strlen(name);
+                if (end != name) options.mRoots.emplace_back(name, end);
+
+                name = *end ? end + 1 : end;
+            }
+        } else if (std::strncmp(argv[i], "-fast-cache=", 12) == 0) {
+            cacheDir = argv[i] + 12;
+        } else if (!fileName) {
+            fileName = argv[i];
+        } else {
+            fileName = nullptr;
+            break;
+        }
+    }
+
+    if (!fileName) {
         std::cout << "crisp: error: Command line requires 1 argument to start the compilation process\n";
         return 1;
     }
 
-    if (access(argv[1], F_OK | R_OK) == -1) {
+    // "-" reads the source from stdin
+    if (std::strcmp(fileName, "-") != 0 && access(fileName, F_OK | R_OK) == -1) {
         std::cout << "crisp: error: Input filename is either non-existent or non-readable\n";
         return 1;
     }
@@ -33,58 +108,96 @@ int main(int argc, char * argv[]) {
 
     -O: enables optimization passes
 
+    -fsyntax-only: only scan, parse and check the input, report any errors and stop before LLVM IR gen
+
+    -fparse-threads=N: scan the whole input up front and parse the function bodies on N threads (0 -> one per core)
+
+    -fnesting-depth=N: allow statements and expressions to nest N levels deep (256 by default), past that is an error.
+    N is capped at 4096 (Parser::MaxSafeDepth) since nested ifs, whiles and parentheses still recurse once per level
+
+    -ferror-limit=N: stop the parse after N errors, the rest of the input is not looked at (0, the default, for no limit)
+
+    -flazy-functions: only compile the functions main calls directly or indirectly, the bodies of the rest are skipped
+    w/o being checked
+
+    -fexport=f,g,...: same but starting from the listed functions instead of main
+
+    -fast-cache=DIR: keep the checked AST of the input in DIR under a hash of the source and the options above, a
+    later compile of the same source loads it from there instead of scanning and parsing it again
+
     -h: prints usage instructions
 
     */ 
 
-    try {
-        // scan input file into tokens
-        Scanner scanner {argv[1]};
-        scanner.scanTokens();
+    Scanner scanner {fileName};
 
-        // designate stdout and stderr stream
-        std::ostream * astStream = &std::cout;
-        std::ostream * errStream = &std::cerr;
+    // designate stdout and stderr stream
+    std::ostream * astStream = &std::cout;
+    std::ostream * errStream = &std::cerr;
 
-        // init SymbolTable and StringTable 
-        SymbolTable symTable {};
-        StringTable strTable {};
+    // init SymbolTable and StringTable 
+    SymbolTable symTable {};
+    StringTable strTable {};
 
-        // parse tokens into AST  
-        // AST can be printed to stdout if specified and no parsing errors
-        Parser parser {scanner, symTable, strTable, argv[1], errStream, astStream};
+    // a source that was compiled before w the same options is picked up from the cache w/o scanning or parsing it
+    std::uint64_t cacheKey = 0;
+    std::string cachePath;
 
-        // if parsing errors don't continue w compilation
-        if (!parser.isValid()) {
-            std::cerr << parser.getNumErrors() << " Error(s)" << std::endl;
-			return 1;
-        }
+    if (cacheDir) {
+        cacheKey = ASTCache::key(scanner.source(), options.mMaxDepth, options.mRoots);
+        cachePath = ASTCache::path(cacheDir, cacheKey);
 
-        // llvm ssa ir gen
-        Emitter emit {parser};
+        ASTCache cache {cachePath.c_str(), cacheKey};
 
-        // if llvm ir gen has error(s) print to cerr and w compilation 
-        if (!emit.verify()) {
-			return 1;
+        if (cache.isValid()) {
+            // printed straight from the cache file
+            if (printAST) {
+                cache.print(*astStream);
+                return 0;
+            }
+
+            // only checked ASTs are cached
+            if (syntaxOnly) return 0;
+
+            Emitter emit {cache.load(strTable), strTable, cache.getPrintf(), fileName};
+
+            return finish(emit);
         }
+    }
 
-        // print llvm ir to stdout 
-        // std::cout << "\nIR before LLVM passes:\n";
-        // emit.print();
+    // tokens are streamed to the parser as it asks for them so only a few are ever held in memory
+    // unless the bodies are parsed in parallel or skipped, that needs every token up front
+    if (options.mThreads == 1 && options.mRoots.empty()) scanner.streamTokens();
+    else scanner.scanTokensParallel(options.mThreads);
 
-        // continue optimizations and mem2reg pass for SSA form 
-        emit.optimize();
+    // parse tokens into AST  
+    // AST can be printed to stdout if specified and no parsing errors
+    // syntax errors are recovered from inside the parser so every one in the file gets reported
+    Parser parser {scanner, symTable, strTable, fileName, errStream, astStream, options};
 
-        // print optimized llvm ir to stdout 
-        // std::cout << "\nIR after LLVM passes:\n";
-        emit.print();
+    // a root that names no function is a mistake in the options, not at any place in the source
+    for (const std::string& root : parser.getMissingRoots()) {
+        std::cerr << "crisp: error: No function named '" << root << "' to compile from\n";
+    }
 
-        // generate bitcode from llvm ir
-        // emit.bitcode();
-    } catch (ParseExcept& e) {
-		std::cerr << "crisp: error: Critical error. Compilation halted." << std::endl;
+    // if parsing errors don't continue w compilation
+    if (!parser.isValid()) {
+        if (parser.getNumErrors()) std::cerr << parser.getNumErrors() << " Error(s)" << std::endl;
 		return 1;
-	}
+    }
+
+    // a cache that cant be written only costs the next compile the parse
+    if (cacheDir) ASTCache::write(cachePath, cacheKey, parser);
+
+    if (printAST) {
+        parser.getRoot()->printNode(*astStream);
+        return 0;
+    }
+
+    if (syntaxOnly) return 0;
+
+    // llvm ssa ir gen
+    Emitter emit {parser};
 
-    return 0;
+    return finish(emit);
 }